@@ -1,29 +1,62 @@
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
+# Temporizadores e contadores dos caminhos quentes (ver instrumentacao.h).
+# Ative com "qmake CONFIG+=instrumentacao"; sem isso não geram código.
+instrumentacao: DEFINES += PROJETOCG_INSTRUMENTACAO
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    armazemobjetos.cpp \
+    armazemvertices.cpp \
+    carregadordesenho.cpp \
+    cenabinaria.cpp \
     clipping.cpp \
+    clippinglote.cpp \
+    gradeespacial.cpp \
+    historico.cpp \
+    instrumentacao.cpp \
     main.cpp \
     mainwindow.cpp \
     matrix.cpp \
+    modeloobjetos.cpp \
     objetografico.cpp \
-    ponto.cpp \
+    renderizacaolote.cpp \
+    renderizador.cpp \
+    renderizadorparalelo.cpp \
+    selecao.cpp \
+    simplificacao.cpp \
+    transformacaolote.cpp \
     transformador.cpp \
     windowgrafica.cpp
 
 HEADERS += \
+    armazemobjetos.h \
+    armazemvertices.h \
+    carregadordesenho.h \
+    cenabinaria.h \
     clipping.h \
+    clippinglote.h \
+    gradeespacial.h \
+    historico.h \
+    instrumentacao.h \
     mainwindow.h \
     matrix.h \
+    modeloobjetos.h \
     objetografico.h \
     ponto.h \
+    renderizacaolote.h \
+    renderizador.h \
+    renderizadorparalelo.h \
+    selecao.h \
+    simplificacao.h \
+    transformacaolote.h \
     transformador.h \
     windowgrafica.h
 
@@ -0,0 +1,39 @@
+#include "armazemobjetos.h"
+
+void ArmazemObjetos::destruir(ObjetoGrafico* obj) {
+    switch (obj->getTipo()) {
+    case TipoObjeto::PONTO: pontos.destruir(static_cast<PontoGrafico*>(obj)); break;
+    case TipoObjeto::RETA: retas.destruir(static_cast<RetaGrafica*>(obj)); break;
+    case TipoObjeto::POLIGONO: poligonos.destruir(static_cast<PoligonoGrafico*>(obj)); break;
+    case TipoObjeto::CURVA: curvas.destruir(static_cast<CurvaGrafica*>(obj)); break;
+    }
+}
+
+void ArmazemObjetos::limpar() {
+    pontos.limpar();
+    retas.limpar();
+    poligonos.limpar();
+    curvas.limpar();
+}
+
+HandleObjeto ArmazemObjetos::handle(const ObjetoGrafico* obj) const {
+    quint32 indice = static_cast<quint32>(obj->getIndicePool());
+    quint32 geracao = 0;
+    switch (obj->getTipo()) {
+    case TipoObjeto::PONTO: geracao = pontos.geracao(indice); break;
+    case TipoObjeto::RETA: geracao = retas.geracao(indice); break;
+    case TipoObjeto::POLIGONO: geracao = poligonos.geracao(indice); break;
+    case TipoObjeto::CURVA: geracao = curvas.geracao(indice); break;
+    }
+    return {obj->getTipo(), indice, geracao};
+}
+
+ObjetoGrafico* ArmazemObjetos::obter(const HandleObjeto& h) const {
+    switch (h.tipo) {
+    case TipoObjeto::PONTO: return pontos.obter(h.indice, h.geracao);
+    case TipoObjeto::RETA: return retas.obter(h.indice, h.geracao);
+    case TipoObjeto::POLIGONO: return poligonos.obter(h.indice, h.geracao);
+    case TipoObjeto::CURVA: return curvas.obter(h.indice, h.geracao);
+    }
+    return nullptr;
+}
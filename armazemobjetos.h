@@ -0,0 +1,177 @@
+#ifndef ARMAZEMOBJETOS_H
+#define ARMAZEMOBJETOS_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <new>
+#include <utility>
+#include "objetografico.h"
+
+// Referência estável a um objeto do ArmazemObjetos. Continua identificando o
+// mesmo objeto enquanto ele existir; depois que ele é destruído, obter()
+// devolve nullptr mesmo que a vaga seja reaproveitada por outro objeto.
+struct HandleObjeto {
+    TipoObjeto tipo;
+    quint32 indice;
+    quint32 geracao;
+
+    bool operator==(const HandleObjeto& o) const {
+        return tipo == o.tipo && indice == o.indice && geracao == o.geracao;
+    }
+    bool operator!=(const HandleObjeto& o) const { return !(*this == o); }
+};
+
+// Objetos de um único tipo guardados em blocos de tamanho fixo. Os blocos não
+// se movem, então os ponteiros são estáveis; vagas liberadas vão para uma
+// lista livre e são reaproveitadas pela próxima criação.
+template <typename T>
+class PoolObjetos {
+public:
+    static const int TAMANHO_BLOCO = 1024;
+
+    PoolObjetos() : vivos(0) {}
+    PoolObjetos(const PoolObjetos&) = delete;
+    PoolObjetos& operator=(const PoolObjetos&) = delete;
+    ~PoolObjetos() {
+        limpar();
+        for (Vaga* bloco : blocos) {
+            delete[] bloco;
+        }
+    }
+
+    template <typename... Args>
+    T* criar(Args&&... args) {
+        if (livres.isEmpty()) {
+            crescer();
+        }
+        quint32 indice = livres.takeLast();
+        T* obj = new (vaga(indice)) T(std::forward<Args>(args)...);
+        obj->indicePool = static_cast<int>(indice);
+        ocupada[indice] = 1;
+        ++vivos;
+        return obj;
+    }
+
+    void destruir(T* obj) {
+        quint32 indice = static_cast<quint32>(obj->indicePool);
+        obj->~T();
+        ocupada[indice] = 0;
+        ++geracoes[indice];
+        livres.append(indice);
+        --vivos;
+    }
+
+    // Destrói todos os objetos; os blocos ficam para as próximas criações.
+    void limpar() {
+        for (int i = 0; i < ocupada.size(); ++i) {
+            if (ocupada[i]) {
+                vaga(i)->~T();
+                ocupada[i] = 0;
+                ++geracoes[i];
+            }
+        }
+        livres.clear();
+        for (int i = ocupada.size() - 1; i >= 0; --i) {
+            livres.append(static_cast<quint32>(i));
+        }
+        vivos = 0;
+    }
+
+    int tamanho() const { return vivos; }
+    quint32 geracao(quint32 indice) const { return geracoes[indice]; }
+
+    T* obter(quint32 indice, quint32 geracao) const {
+        if (indice >= static_cast<quint32>(ocupada.size()) || !ocupada[indice] || geracoes[indice] != geracao) {
+            return nullptr;
+        }
+        return vaga(indice);
+    }
+
+    // Percorre os objetos vivos na ordem da memória, bloco a bloco.
+    template <typename F>
+    void paraCada(F f) const {
+        for (int i = 0; i < ocupada.size(); ++i) {
+            if (ocupada[i]) f(vaga(i));
+        }
+    }
+
+private:
+    struct Vaga {
+        alignas(T) unsigned char dados[sizeof(T)];
+    };
+
+    T* vaga(int indice) const {
+        return reinterpret_cast<T*>(blocos[indice / TAMANHO_BLOCO][indice % TAMANHO_BLOCO].dados);
+    }
+
+    void crescer() {
+        int primeiro = ocupada.size();
+        blocos.append(new Vaga[TAMANHO_BLOCO]);
+        ocupada.resize(primeiro + TAMANHO_BLOCO);
+        geracoes.resize(primeiro + TAMANHO_BLOCO);
+        // Em ordem decrescente, para a pilha entregar as vagas de menor índice primeiro.
+        for (int i = primeiro + TAMANHO_BLOCO - 1; i >= primeiro; --i) {
+            livres.append(static_cast<quint32>(i));
+        }
+    }
+
+    QVector<Vaga*> blocos;
+    QVector<quint8> ocupada;
+    QVector<quint32> geracoes;
+    QVector<quint32> livres;
+    int vivos;
+};
+
+// Dono de todos os objetos da cena, separados por tipo. Criar e destruir não
+// passam pelo heap (exceto quando um bloco novo é necessário) e percorrer todas
+// as retas ou todos os polígonos lê memória contígua. A ordem de exibição
+// continua no display file, que guarda só ponteiros para cá.
+class ArmazemObjetos {
+public:
+    explicit ArmazemObjetos(ArmazemVertices* vertices) : vertices(vertices) {}
+
+    PontoGrafico* criarPonto(const QString& nome, const Ponto& p) {
+        return pontos.criar(vertices, nome, p);
+    }
+    RetaGrafica* criarReta(const QString& nome, const Ponto& p1, const Ponto& p2) {
+        return retas.criar(vertices, nome, p1, p2);
+    }
+    PoligonoGrafico* criarPoligono(const QString& nome, const QVector<Ponto>& pontos, bool preenchido = false) {
+        return poligonos.criar(vertices, nome, pontos, preenchido);
+    }
+    PoligonoGrafico* criarPoligono(const QString& nome, const double* xs, const double* ys, int n,
+                                   bool preenchido = false) {
+        return poligonos.criar(vertices, nome, xs, ys, n, preenchido);
+    }
+    CurvaGrafica* criarCurva(const QString& nome, TipoCurva tipoCurva, const QVector<Ponto>& controle) {
+        return curvas.criar(vertices, nome, tipoCurva, controle);
+    }
+    CurvaGrafica* criarCurva(const QString& nome, TipoCurva tipoCurva, const double* xs, const double* ys, int n) {
+        return curvas.criar(vertices, nome, tipoCurva, xs, ys, n);
+    }
+
+    // 'obj' tem de ter sido criado por este armazém.
+    void destruir(ObjetoGrafico* obj);
+    void limpar();
+
+    HandleObjeto handle(const ObjetoGrafico* obj) const;
+    // nullptr se o objeto do handle já foi destruído.
+    ObjetoGrafico* obter(const HandleObjeto& h) const;
+
+    int tamanho() const { return pontos.tamanho() + retas.tamanho() + poligonos.tamanho() + curvas.tamanho(); }
+    ArmazemVertices* getVertices() const { return vertices; }
+
+    const PoolObjetos<PontoGrafico>& getPontos() const { return pontos; }
+    const PoolObjetos<RetaGrafica>& getRetas() const { return retas; }
+    const PoolObjetos<PoligonoGrafico>& getPoligonos() const { return poligonos; }
+    const PoolObjetos<CurvaGrafica>& getCurvas() const { return curvas; }
+
+private:
+    ArmazemVertices* vertices;
+    PoolObjetos<PontoGrafico> pontos;
+    PoolObjetos<RetaGrafica> retas;
+    PoolObjetos<PoligonoGrafico> poligonos;
+    PoolObjetos<CurvaGrafica> curvas;
+};
+
+#endif // ARMAZEMOBJETOS_H
@@ -0,0 +1,52 @@
+#include "armazemvertices.h"
+#include "objetografico.h"
+#include "transformacaolote.h"
+
+ArmazemVertices::ArmazemVertices() : livres(0) {}
+
+int ArmazemVertices::alocar(int quantidade) {
+    int inicio = x.size();
+    x.resize(inicio + quantidade);
+    y.resize(inicio + quantidade);
+    return inicio;
+}
+
+void ArmazemVertices::liberar(int inicio, int quantidade) {
+    if (inicio + quantidade == x.size()) {
+        // Faixa no fim do armazém: basta encolher.
+        x.resize(inicio);
+        y.resize(inicio);
+    } else {
+        livres += quantidade;
+    }
+}
+
+void ArmazemVertices::reservar(int quantidade) {
+    x.reserve(x.size() + quantidade);
+    y.reserve(y.size() + quantidade);
+}
+
+void ArmazemVertices::aplicarTransformacao(const Mat3& matriz, int inicio, int quantidade) {
+    transformarLote(matriz, x.data() + inicio, y.data() + inicio, quantidade);
+}
+
+void ArmazemVertices::compactar(const QVector<ObjetoGrafico*>& objetos) {
+    QVector<double> novoX;
+    QVector<double> novoY;
+    novoX.reserve(x.size() - livres);
+    novoY.reserve(y.size() - livres);
+
+    for (ObjetoGrafico* obj : objetos) {
+        if (obj->armazem != this) continue;
+        int novoInicio = novoX.size();
+        for (int i = 0; i < obj->quantidade; ++i) {
+            novoX.append(x[obj->inicio + i]);
+            novoY.append(y[obj->inicio + i]);
+        }
+        obj->inicio = novoInicio;
+    }
+
+    x.swap(novoX);
+    y.swap(novoY);
+    livres = 0;
+}
@@ -0,0 +1,38 @@
+#ifndef ARMAZEMVERTICES_H
+#define ARMAZEMVERTICES_H
+
+#include <QVector>
+#include "matrix.h"
+
+class ObjetoGrafico;
+
+// Guarda os vértices de toda a cena em dois vetores contíguos (x[] e y[]).
+// Cada objeto guarda apenas a faixa [inicio, inicio + quantidade) que ocupa.
+class ArmazemVertices {
+public:
+    ArmazemVertices();
+
+    int alocar(int quantidade);
+    void liberar(int inicio, int quantidade);
+    void reservar(int quantidade);
+
+    double* xs() { return x.data(); }
+    double* ys() { return y.data(); }
+    const double* xs() const { return x.constData(); }
+    const double* ys() const { return y.constData(); }
+
+    int tamanho() const { return x.size(); }
+    int desperdicio() const { return livres; }
+
+    void aplicarTransformacao(const Mat3& matriz, int inicio, int quantidade);
+
+    // Remove os buracos deixados por objetos excluídos, atualizando as faixas.
+    void compactar(const QVector<ObjetoGrafico*>& objetos);
+
+private:
+    QVector<double> x;
+    QVector<double> y;
+    int livres;
+};
+
+#endif // ARMAZEMVERTICES_H
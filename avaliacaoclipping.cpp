@@ -0,0 +1,89 @@
+#include "avaliacaoclipping.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+const double TOLERANCIA = 1e-9;
+
+struct Segmentos {
+    QVector<double> x1, y1, x2, y2;
+    QVector<unsigned char> aceito;
+};
+
+bool iguais(double a, double b) {
+    return std::abs(a - b) <= TOLERANCIA * std::max(1.0, std::abs(a));
+}
+}
+
+QVector<ResultadoAvaliacaoClipping> avaliarAlgoritmosClipping(int numSegmentos) {
+    // Segmentos em [-3, 3]: parte dentro, parte fora e parte cruzando a window normalizada.
+    Segmentos entrada;
+    std::mt19937 gerador(12345);
+    std::uniform_real_distribution<double> coordenada(-3.0, 3.0);
+    for (QVector<double>* v : {&entrada.x1, &entrada.y1, &entrada.x2, &entrada.y2}) {
+        v->resize(numSegmentos);
+    }
+    for (int i = 0; i < numSegmentos; ++i) {
+        entrada.x1[i] = coordenada(gerador);
+        entrada.y1[i] = coordenada(gerador);
+        entrada.x2[i] = coordenada(gerador);
+        entrada.y2[i] = coordenada(gerador);
+    }
+
+    const LimitesWindow limites = WindowGrafica::limitesNormalizados();
+    const AlgoritmoClipping algoritmos[] = {
+        AlgoritmoClipping::COHEN_SUTHERLAND,
+        AlgoritmoClipping::LIANG_BARSKY,
+        AlgoritmoClipping::LIANG_BARSKY_LOTE
+    };
+
+    QVector<ResultadoAvaliacaoClipping> resultados;
+    Segmentos referencia;
+    Clipping clipper;
+
+    for (AlgoritmoClipping algoritmo : algoritmos) {
+        Segmentos s = entrada;
+        s.aceito.resize(numSegmentos);
+        clipper.setAlgoritmo(algoritmo);
+
+        QElapsedTimer cronometro;
+        cronometro.start();
+        clipper.clipRetas(s.x1.data(), s.y1.data(), s.x2.data(), s.y2.data(), numSegmentos, limites, s.aceito.data());
+        double ms = cronometro.nsecsElapsed() / 1e6;
+
+        if (algoritmo == AlgoritmoClipping::COHEN_SUTHERLAND) {
+            referencia = s;
+        }
+
+        int aceitos = 0;
+        int divergencias = 0;
+        for (int i = 0; i < numSegmentos; ++i) {
+            aceitos += s.aceito[i];
+            if (s.aceito[i] != referencia.aceito[i]) {
+                ++divergencias;
+            } else if (s.aceito[i] && !(iguais(s.x1[i], referencia.x1[i]) && iguais(s.y1[i], referencia.y1[i])
+                                        && iguais(s.x2[i], referencia.x2[i]) && iguais(s.y2[i], referencia.y2[i]))) {
+                ++divergencias;
+            }
+        }
+
+        double segundos = ms / 1000.0;
+        resultados.append({algoritmo, ms, segundos > 0 ? numSegmentos / segundos : 0.0, aceitos, divergencias});
+    }
+    return resultados;
+}
+
+QString formatarAvaliacaoClipping(const QVector<ResultadoAvaliacaoClipping>& resultados, int numSegmentos) {
+    QString texto = QString("%1 segmentos aleatórios:\n\n").arg(numSegmentos);
+    for (const ResultadoAvaliacaoClipping& r : resultados) {
+        texto += QString("%1\n  %2 ms, %3 M segmentos/s, %4 aceitos, %5 divergências\n")
+                     .arg(Clipping::nomeAlgoritmo(r.algoritmo))
+                     .arg(r.milissegundos, 0, 'f', 2)
+                     .arg(r.segmentosPorSegundo / 1e6, 0, 'f', 1)
+                     .arg(r.aceitos)
+                     .arg(r.divergencias);
+    }
+    return texto;
+}
@@ -0,0 +1,22 @@
+#ifndef AVALIACAOCLIPPING_H
+#define AVALIACAOCLIPPING_H
+
+#include <QString>
+#include <QVector>
+#include "clipping.h"
+
+struct ResultadoAvaliacaoClipping {
+    AlgoritmoClipping algoritmo;
+    double milissegundos;
+    double segmentosPorSegundo;
+    int aceitos;
+    int divergencias; // segmentos com resultado diferente do Cohen-Sutherland
+};
+
+// Recorta os mesmos segmentos aleatórios com cada algoritmo, mede a vazão e
+// confere o resultado de cada um contra o Cohen-Sutherland.
+QVector<ResultadoAvaliacaoClipping> avaliarAlgoritmosClipping(int numSegmentos);
+
+QString formatarAvaliacaoClipping(const QVector<ResultadoAvaliacaoClipping>& resultados, int numSegmentos);
+
+#endif // AVALIACAOCLIPPING_H
@@ -0,0 +1,57 @@
+# Benchmark sem interface do pipeline de geometria e renderização.
+# Usa os mesmos fontes do ProjetoCG (exceto a janela principal).
+
+QT += core gui concurrent
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+instrumentacao: DEFINES += PROJETOCG_INSTRUMENTACAO
+
+TARGET = benchmark
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    cenasintetica.cpp \
+    main.cpp \
+    ../armazemobjetos.cpp \
+    ../armazemvertices.cpp \
+    ../avaliacaoclipping.cpp \
+    ../carregadordesenho.cpp \
+    ../cenabinaria.cpp \
+    ../clipping.cpp \
+    ../clippinglote.cpp \
+    ../gradeespacial.cpp \
+    ../instrumentacao.cpp \
+    ../matrix.cpp \
+    ../objetografico.cpp \
+    ../renderizador.cpp \
+    ../renderizadorparalelo.cpp \
+    ../selecao.cpp \
+    ../simplificacao.cpp \
+    ../transformacaolote.cpp \
+    ../transformador.cpp \
+    ../windowgrafica.cpp
+
+HEADERS += \
+    cenasintetica.h \
+    ../armazemobjetos.h \
+    ../armazemvertices.h \
+    ../avaliacaoclipping.h \
+    ../carregadordesenho.h \
+    ../cenabinaria.h \
+    ../clipping.h \
+    ../clippinglote.h \
+    ../gradeespacial.h \
+    ../instrumentacao.h \
+    ../matrix.h \
+    ../objetografico.h \
+    ../ponto.h \
+    ../renderizador.h \
+    ../renderizadorparalelo.h \
+    ../selecao.h \
+    ../simplificacao.h \
+    ../transformacaolote.h \
+    ../transformador.h \
+    ../windowgrafica.h
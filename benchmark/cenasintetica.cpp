@@ -0,0 +1,105 @@
+#include "cenasintetica.h"
+#include <QFile>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace {
+// casa.txt, com a origem no canto superior esquerdo da caixa do desenho.
+const double CASA[6][4] = {
+    {0, 250, 200, 250}, {200, 250, 200, 100}, {200, 100, 0, 100},
+    {0, 100, 0, 250}, {0, 100, 100, 0}, {100, 0, 200, 100}
+};
+
+// Casco de barco.txt, na mesma convenção.
+const double BARCO[4][2] = {{0, 0}, {250, 0}, {200, 50}, {50, 50}};
+
+// Espaço médio reservado a cada objeto, em unidades do mundo.
+const double AREA_POR_OBJETO = 60.0 * 60.0;
+}
+
+double ladoMundoSintetico(int n) {
+    return std::sqrt(std::max(1, n) * AREA_POR_OBJETO);
+}
+
+QVector<double> gerarSegmentos(int n, quint32 semente) {
+    std::mt19937 gerador(semente);
+    const double lado = ladoMundoSintetico(n);
+    std::uniform_real_distribution<double> posicao(0.0, lado);
+    std::uniform_real_distribution<double> escala(0.05, 0.6);
+
+    QVector<double> segmentos(4 * n);
+    double ox = 0, oy = 0, s = 1;
+    for (int i = 0; i < n; ++i) {
+        int k = i % 6;
+        if (k == 0) {
+            ox = posicao(gerador);
+            oy = posicao(gerador);
+            s = escala(gerador);
+        }
+        double* d = segmentos.data() + 4 * i;
+        d[0] = ox + s * CASA[k][0];
+        d[1] = oy + s * CASA[k][1];
+        d[2] = ox + s * CASA[k][2];
+        d[3] = oy + s * CASA[k][3];
+    }
+    return segmentos;
+}
+
+QVector<double> gerarPontos(int n, quint32 semente) {
+    std::mt19937 gerador(semente);
+    std::uniform_real_distribution<double> posicao(0.0, ladoMundoSintetico(n));
+    QVector<double> pontos(2 * n);
+    for (double& v : pontos) {
+        v = posicao(gerador);
+    }
+    return pontos;
+}
+
+void gerarPoligonos(int n, quint32 semente, QVector<double>& xs, QVector<double>& ys, QVector<int>& tamanhos) {
+    std::mt19937 gerador(semente);
+    std::uniform_real_distribution<double> posicao(0.0, ladoMundoSintetico(n));
+    std::uniform_real_distribution<double> escala(0.05, 0.4);
+
+    xs.clear();
+    ys.clear();
+    tamanhos.fill(4, n);
+    xs.reserve(4 * n);
+    ys.reserve(4 * n);
+    for (int i = 0; i < n; ++i) {
+        double ox = posicao(gerador), oy = posicao(gerador), s = escala(gerador);
+        for (const double* v : BARCO) {
+            xs.append(ox + s * v[0]);
+            ys.append(oy + s * v[1]);
+        }
+    }
+}
+
+void gerarPoligonoDenso(int n, double raio, QVector<double>& xs, QVector<double>& ys) {
+    xs.resize(n);
+    ys.resize(n);
+    for (int i = 0; i < n; ++i) {
+        double t = 2.0 * M_PI * i / n;
+        double r = raio * (1.0 + 0.05 * std::sin(40.0 * t));
+        xs[i] = r * std::cos(t);
+        ys[i] = r * std::sin(t);
+    }
+}
+
+bool gravarDesenhoTexto(const QString& caminho, const QVector<double>& segmentos) {
+    QFile arquivo(caminho);
+    if (!arquivo.open(QIODevice::WriteOnly)) return false;
+
+    QByteArray texto;
+    char linha[128];
+    for (int i = 0; i + 3 < segmentos.size(); i += 4) {
+        int tamanho = std::snprintf(linha, sizeof(linha), "(%.3f,%.3f) (%.3f,%.3f)\n",
+                                    segmentos[i], segmentos[i + 1], segmentos[i + 2], segmentos[i + 3]);
+        texto.append(linha, tamanho);
+        if (texto.size() > (1 << 20)) {
+            if (arquivo.write(texto) != texto.size()) return false;
+            texto.clear();
+        }
+    }
+    return arquivo.write(texto) == texto.size();
+}
@@ -0,0 +1,33 @@
+#ifndef CENASINTETICA_H
+#define CENASINTETICA_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// Cenas artificiais para o benchmark. Os desenhos de exemplo (a casa de
+// casa.txt e o casco de barco.txt) são repetidos com escala e posição
+// aleatórias num mundo quadrado cujo lado cresce com a raiz de n, para a
+// densidade ficar parecida em todos os tamanhos. A mesma semente gera sempre
+// a mesma cena.
+
+// Lado do mundo para uma cena de n objetos.
+double ladoMundoSintetico(int n);
+
+// n segmentos (x1, y1, x2, y2 de cada um), agrupados em casas de 6 segmentos.
+QVector<double> gerarSegmentos(int n, quint32 semente);
+
+// n pontos (x, y de cada um).
+QVector<double> gerarPontos(int n, quint32 semente);
+
+// n polígonos com o contorno do casco do barco; os vértices de todos ficam em
+// sequência em xs/ys e tamanhos[i] diz quantos pertencem ao polígono i.
+void gerarPoligonos(int n, quint32 semente, QVector<double>& xs, QVector<double>& ys, QVector<int>& tamanhos);
+
+// Um único polígono fechado de n vértices, uma curva ondulada de raio 'raio'.
+void gerarPoligonoDenso(int n, double raio, QVector<double>& xs, QVector<double>& ys);
+
+// Grava os segmentos no formato de desenho "(x1,y1) (x2,y2)", um por linha.
+bool gravarDesenhoTexto(const QString& caminho, const QVector<double>& segmentos);
+
+#endif // CENASINTETICA_H
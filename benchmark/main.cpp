@@ -0,0 +1,491 @@
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <initializer_list>
+#include <random>
+
+#include "cenasintetica.h"
+#include "armazemobjetos.h"
+#include "armazemvertices.h"
+#include "avaliacaoclipping.h"
+#include "carregadordesenho.h"
+#include "cenabinaria.h"
+#include "clipping.h"
+#include "gradeespacial.h"
+#include "matrix.h"
+#include "renderizador.h"
+#include "renderizadorparalelo.h"
+#include "selecao.h"
+#include "transformador.h"
+#include "windowgrafica.h"
+
+// Benchmark sem interface do pipeline de geometria e renderização. Para cada
+// tamanho de 10^min a 10^max gera cenas sintéticas, mede cada caso algumas
+// vezes e grava os tempos em JSON, para comparar execuções entre versões.
+//
+//   benchmark --min 3 --max 6 --repeticoes 5 --saida resultado.json
+//
+// Antes de medir, os três algoritmos de clipping são conferidos entre si; se
+// algum divergir (uma regressão no recorte em lote, por exemplo), o benchmark
+// sai com código 1. "benchmark --conferir" faz só essa conferência.
+
+namespace {
+const int LARGURA_IMAGEM = 1280;
+const int ALTURA_IMAGEM = 720;
+const int CONSULTAS_SELECAO = 1000;
+const int SEGMENTOS_CONFERENCIA = 100000;
+
+// Impede o compilador de descartar os laços medidos.
+volatile double sumidouro = 0.0;
+
+class Benchmark {
+public:
+    Benchmark(int repeticoes, const QString& filtro) : repeticoes(repeticoes), filtro(filtro) {}
+
+    bool ativo(const QString& caso) const {
+        return filtro.isEmpty() || caso.contains(filtro);
+    }
+
+    // Evita preparar dados de um grupo de casos se nenhum deles vai rodar.
+    bool algumAtivo(std::initializer_list<const char*> casos) const {
+        return std::any_of(casos.begin(), casos.end(), [this](const char* caso) { return ativo(caso); });
+    }
+
+    // Roda 'corpo' uma vez para aquecer e depois 'repeticoes' vezes. 'preparar'
+    // roda antes de cada execução, fora do tempo medido. 'operacoes' é o que
+    // conta para a vazão (por padrão, n).
+    void medir(const QString& caso, qint64 n, const std::function<void()>& corpo,
+               const std::function<void()>& preparar = nullptr, qint64 operacoes = -1) {
+        if (!ativo(caso)) return;
+
+        QVector<double> tempos;
+        for (int i = 0; i <= repeticoes; ++i) {
+            if (preparar) preparar();
+            QElapsedTimer cronometro;
+            cronometro.start();
+            corpo();
+            double ms = cronometro.nsecsElapsed() / 1e6;
+            if (i > 0) tempos.append(ms);
+        }
+        std::sort(tempos.begin(), tempos.end());
+
+        if (operacoes < 0) operacoes = n;
+        double minimo = tempos.first();
+        QJsonObject r;
+        r["caso"] = caso;
+        r["n"] = n;
+        r["operacoes"] = operacoes;
+        r["repeticoes"] = repeticoes;
+        r["ms_min"] = minimo;
+        r["ms_mediana"] = tempos[tempos.size() / 2];
+        r["ms_max"] = tempos.last();
+        r["por_segundo"] = minimo > 0.0 ? operacoes / (minimo / 1000.0) : 0.0;
+        resultados.append(r);
+
+        std::fprintf(stderr, "%-32s n=%-9lld %10.3f ms\n", qPrintable(caso), static_cast<long long>(n), minimo);
+    }
+
+    QJsonArray getResultados() const { return resultados; }
+
+private:
+    int repeticoes;
+    QString filtro;
+    QJsonArray resultados;
+};
+
+// Uma cena completa, como a da janela principal: 60% retas, 20% pontos e 20% polígonos.
+struct Cena {
+    ArmazemVertices vertices;
+    ArmazemObjetos objetos;
+    GradeEspacial grade;
+    WindowGrafica* window;
+    QVector<ObjetoGrafico*> lista;
+    double lado;
+
+    explicit Cena(int n) : objetos(&vertices), window(nullptr), lado(ladoMundoSintetico(n)) {
+        int numRetas = n * 6 / 10;
+        int numPontos = n * 2 / 10;
+        int numPoligonos = n - numRetas - numPontos;
+
+        QVector<double> segmentos = gerarSegmentos(numRetas, 1);
+        QVector<double> pontos = gerarPontos(numPontos, 2);
+        QVector<double> xs, ys;
+        QVector<int> tamanhos;
+        gerarPoligonos(numPoligonos, 3, xs, ys, tamanhos);
+
+        vertices.reservar(2 * numRetas + numPontos + xs.size() + 4);
+        lista.reserve(n);
+        for (int i = 0; i < numRetas; ++i) {
+            const double* s = segmentos.constData() + 4 * i;
+            lista.append(objetos.criarReta(QString(), Ponto(s[0], s[1]), Ponto(s[2], s[3])));
+        }
+        for (int i = 0; i < numPontos; ++i) {
+            lista.append(objetos.criarPonto(QString(), Ponto(pontos[2 * i], pontos[2 * i + 1])));
+        }
+        for (int i = 0, inicio = 0; i < numPoligonos; inicio += tamanhos[i++]) {
+            lista.append(objetos.criarPoligono(QString(), xs.constData() + inicio, ys.constData() + inicio,
+                                               tamanhos[i], i % 2 == 0));
+        }
+        for (ObjetoGrafico* obj : lista) {
+            grade.inserir(obj);
+        }
+        window = new WindowGrafica(&vertices, "Window", Ponto(0, 0), Ponto(lado, lado));
+    }
+
+    ~Cena() {
+        delete window;
+    }
+};
+
+Mat3 transformacaoViewport() {
+    TransformadorCoordenadas transformador;
+    transformador.setWindow(-1.0, -1.0, 1.0, 1.0);
+    transformador.setViewport(0, 0, LARGURA_IMAGEM, ALTURA_IMAGEM);
+    return transformador.getTransformacao();
+}
+
+void medirMatrizes(Benchmark& b, int n) {
+    b.medir("mat3_multiplicacao", n, [n]() {
+        const Mat3 R = Mat3::criarMatrizRotacao(0.001);
+        Mat3 acumulada;
+        for (int i = 0; i < n; ++i) {
+            acumulada = R * acumulada;
+        }
+        sumidouro = sumidouro + acumulada.at(0, 0);
+    });
+
+    b.medir("mat3_vezes_ponto", n, [n]() {
+        const Mat3 M = Mat3::criarMatrizTranslacao(1.0, 2.0) * Mat3::criarMatrizRotacao(30.0);
+        Ponto p(1.0, 0.0);
+        for (int i = 0; i < n; ++i) {
+            p = M * p;
+        }
+        sumidouro = sumidouro + p.getX();
+    });
+
+    if (b.ativo("armazem_transformacao")) {
+        ArmazemVertices armazem;
+        int inicio = armazem.alocar(n);
+        std::mt19937 gerador(4);
+        std::uniform_real_distribution<double> coordenada(-1000.0, 1000.0);
+        for (int i = 0; i < n; ++i) {
+            armazem.xs()[inicio + i] = coordenada(gerador);
+            armazem.ys()[inicio + i] = coordenada(gerador);
+        }
+        const Mat3 M = Mat3::criarMatrizRotacao(0.5);
+        b.medir("armazem_transformacao", n, [&armazem, &M, inicio, n]() {
+            armazem.aplicarTransformacao(M, inicio, n);
+        });
+    }
+}
+
+void medirTransformacaoObjetos(Benchmark& b, int n) {
+    if (!b.algumAtivo({"aplicarTransformacao", "consolidar"})) return;
+
+    ArmazemVertices vertices;
+    ArmazemObjetos objetos(&vertices);
+    QVector<ObjetoGrafico*> retas;
+    QVector<double> segmentos = gerarSegmentos(n, 5);
+    retas.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        const double* s = segmentos.constData() + 4 * i;
+        retas.append(objetos.criarReta(QString(), Ponto(s[0], s[1]), Ponto(s[2], s[3])));
+    }
+    const Mat3 M = Mat3::criarMatrizTranslacao(3.0, -2.0) * Mat3::criarMatrizRotacao(1.0);
+
+    b.medir("aplicarTransformacao", n, [&retas, &M]() {
+        for (ObjetoGrafico* obj : retas) {
+            obj->aplicarTransformacao(M);
+        }
+    });
+    b.medir("consolidar", n, [&retas]() {
+        for (ObjetoGrafico* obj : retas) {
+            obj->consolidar();
+        }
+    }, [&retas, &M]() {
+        for (ObjetoGrafico* obj : retas) {
+            obj->aplicarTransformacao(M);
+        }
+    });
+}
+
+void medirClipping(Benchmark& b, int n) {
+    if (!b.algumAtivo({"clipReta_cohen_sutherland", "clipReta_liang_barsky", "clipRetas_lote", "clipPonto"})) return;
+
+    // Segmentos em [-3, 3]: parte dentro, parte fora e parte cruzando a window normalizada.
+    std::mt19937 gerador(6);
+    std::uniform_real_distribution<double> coordenada(-3.0, 3.0);
+    QVector<double> x1(n), y1(n), x2(n), y2(n);
+    for (int i = 0; i < n; ++i) {
+        x1[i] = coordenada(gerador);
+        y1[i] = coordenada(gerador);
+        x2[i] = coordenada(gerador);
+        y2[i] = coordenada(gerador);
+    }
+    const LimitesWindow limites = WindowGrafica::limitesNormalizados();
+    Clipping clipper;
+
+    const AlgoritmoClipping porSegmento[] = {AlgoritmoClipping::COHEN_SUTHERLAND, AlgoritmoClipping::LIANG_BARSKY};
+    const char* nomes[] = {"clipReta_cohen_sutherland", "clipReta_liang_barsky"};
+    for (int a = 0; a < 2; ++a) {
+        clipper.setAlgoritmo(porSegmento[a]);
+        b.medir(nomes[a], n, [&]() {
+            int aceitos = 0;
+            for (int i = 0; i < n; ++i) {
+                Ponto p1(x1[i], y1[i]), p2(x2[i], y2[i]);
+                aceitos += clipper.clipReta(p1, p2, limites);
+            }
+            sumidouro = sumidouro + aceitos;
+        });
+    }
+
+    QVector<double> lx1, ly1, lx2, ly2;
+    QVector<unsigned char> aceito(n);
+    clipper.setAlgoritmo(AlgoritmoClipping::LIANG_BARSKY_LOTE);
+    b.medir("clipRetas_lote", n, [&]() {
+        clipper.clipRetas(lx1.data(), ly1.data(), lx2.data(), ly2.data(), n, limites, aceito.data());
+    }, [&]() {
+        lx1 = x1;
+        ly1 = y1;
+        lx2 = x2;
+        ly2 = y2;
+        lx1.detach();
+        ly1.detach();
+        lx2.detach();
+        ly2.detach();
+    });
+
+    b.medir("clipPonto", n, [&]() {
+        int aceitos = 0;
+        for (int i = 0; i < n; ++i) {
+            aceitos += clipper.clipPonto(Ponto(x1[i], y1[i]), limites);
+        }
+        sumidouro = sumidouro + aceitos;
+    });
+}
+
+void medirArquivos(Benchmark& b, int n, const QTemporaryDir& temporario) {
+    if (b.ativo("carregar_texto")) {
+        QString caminho = temporario.filePath(QString("desenho_%1.txt").arg(n));
+        if (gravarDesenhoTexto(caminho, gerarSegmentos(n, 7))) {
+            b.medir("carregar_texto", n, [&caminho]() {
+                CarregadorDesenho carregador;
+                carregador.carregar(caminho);
+                sumidouro = sumidouro + carregador.getNumSegmentos();
+            });
+        } else {
+            std::fprintf(stderr, "Não foi possível gravar %s\n", qPrintable(caminho));
+        }
+        QFile::remove(caminho);
+    }
+
+    if (b.algumAtivo({"cena_binaria_salvar", "cena_binaria_carregar"})) {
+        Cena cena(n);
+        QString caminho = temporario.filePath(QString("cena_%1.cgcena").arg(n));
+        b.medir("cena_binaria_salvar", n, [&]() {
+            CenaBinaria().salvar(caminho, cena.lista, cena.window);
+        });
+        b.medir("cena_binaria_carregar", n, [&]() {
+            ArmazemVertices vertices;
+            ArmazemObjetos objetos(&vertices);
+            WindowGrafica window(&vertices, "Window", Ponto(0, 0), Ponto(1, 1));
+            QVector<ObjetoGrafico*> lidos;
+            CenaBinaria().carregar(caminho, &objetos, lidos, &window);
+            sumidouro = sumidouro + lidos.size();
+        });
+        QFile::remove(caminho);
+    }
+}
+
+void medirCena(Benchmark& b, int n) {
+    if (!b.algumAtivo({"grade_inserir", "renderizar_completo", "renderizar_paralelo_completo",
+                       "renderizar_zoom", "renderizar_paralelo_zoom", "selecionar"})) return;
+
+    Cena cena(n);
+
+    b.medir("grade_inserir", n, [&cena]() {
+        for (ObjetoGrafico* obj : cena.lista) {
+            cena.grade.inserir(obj);
+        }
+    }, [&cena]() {
+        cena.grade.limpar();
+    });
+
+    const Mat3 T_vp = transformacaoViewport();
+    QImage imagem(LARGURA_IMAGEM, ALTURA_IMAGEM, QImage::Format_ARGB32_Premultiplied);
+    Clipping clipper;
+    Renderizador renderizador(clipper);
+    RenderizadorParalelo renderizadorParalelo(clipper);
+
+    // Equivalente ao paintEvent com a cena suja: limpa a imagem e redesenha tudo.
+    auto renderizar = [&]() {
+        imagem.fill(Qt::transparent);
+        QPainter painter(&imagem);
+        renderizador.desenharCena(painter, cena.grade, cena.window, T_vp);
+    };
+    auto renderizarParalelo = [&]() {
+        imagem.fill(Qt::transparent);
+        renderizadorParalelo.desenharCena(imagem, QPoint(0, 0), imagem.rect(), cena.grade, cena.window, T_vp);
+    };
+
+    b.medir("renderizar_completo", n, renderizar);
+    b.medir("renderizar_paralelo_completo", n, renderizarParalelo);
+
+    // Window cobrindo 1/32 do lado do mundo, no centro.
+    double meio = cena.lado / 2.0, raio = cena.lado / 64.0;
+    cena.window->atualizarLimites(meio - raio, meio - raio, meio + raio, meio + raio);
+    b.medir("renderizar_zoom", n, renderizar);
+    b.medir("renderizar_paralelo_zoom", n, renderizarParalelo);
+
+    if (b.ativo("selecionar")) {
+        // Mesma tolerância da janela: 5 pixels na escala da window atual.
+        Mat3 T_total = T_vp * cena.window->getMatrizNormalizacao();
+        double escala = std::sqrt(std::abs(T_total.at(0, 0) * T_total.at(1, 1) - T_total.at(0, 1) * T_total.at(1, 0)));
+        double tolerancia = 5.0 / escala;
+        std::mt19937 gerador(8);
+        std::uniform_real_distribution<double> coordenada(meio - raio, meio + raio);
+        QVector<double> consultas(2 * CONSULTAS_SELECAO);
+        for (double& c : consultas) {
+            c = coordenada(gerador);
+        }
+        SeletorObjetos seletor;
+        b.medir("selecionar", n, [&]() {
+            int encontrados = 0;
+            for (int i = 0; i < CONSULTAS_SELECAO; ++i) {
+                encontrados += seletor.selecionar(cena.grade, consultas[2 * i], consultas[2 * i + 1], tolerancia) != nullptr;
+            }
+            sumidouro = sumidouro + encontrados;
+        }, nullptr, CONSULTAS_SELECAO);
+    }
+}
+
+void medirPoligonoDenso(Benchmark& b, int n) {
+    if (!b.algumAtivo({"poligono_denso_piramide", "poligono_denso_renderizar",
+                       "poligono_denso_renderizar_recorte"})) return;
+
+    ArmazemVertices vertices;
+    QVector<double> xs, ys;
+    gerarPoligonoDenso(n, 1000.0, xs, ys);
+    PoligonoGrafico poligono(&vertices, QString(), xs.constData(), ys.constData(), n);
+    GradeEspacial grade;
+
+    b.medir("poligono_denso_piramide", n, [&]() {
+        grade.inserir(&poligono);
+    }, [&]() {
+        grade.limpar();
+        poligono.setVertices(xs.constData(), ys.constData());
+    });
+
+    const Mat3 T_vp = transformacaoViewport();
+    QImage imagem(LARGURA_IMAGEM, ALTURA_IMAGEM, QImage::Format_ARGB32_Premultiplied);
+    Clipping clipper;
+    Renderizador renderizador(clipper);
+    WindowGrafica window(&vertices, "Window", Ponto(-1100, -1100), Ponto(1100, 1100));
+    auto renderizar = [&]() {
+        imagem.fill(Qt::transparent);
+        QPainter painter(&imagem);
+        renderizador.desenharCena(painter, grade, &window, T_vp);
+    };
+    b.medir("poligono_denso_renderizar", n, renderizar);
+
+    // Só um pedaço do contorno visível: exercita o recorte do polígono inteiro.
+    window.atualizarLimites(900, -100, 1100, 100);
+    b.medir("poligono_denso_renderizar_recorte", n, renderizar);
+}
+}
+
+int main(int argc, char *argv[])
+{
+    // Sem janelas: o QPainter só desenha em QImage.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication aplicacao(argc, argv);
+    QGuiApplication::setApplicationName("benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark do pipeline de geometria e renderização do ProjetoCG.");
+    parser.addHelpOption();
+    QCommandLineOption opcaoMin("min", "Menor tamanho: 10^<expoente> objetos.", "expoente", "3");
+    QCommandLineOption opcaoMax("max", "Maior tamanho: 10^<expoente> objetos.", "expoente", "6");
+    QCommandLineOption opcaoRepeticoes("repeticoes", "Execuções medidas por caso.", "n", "5");
+    QCommandLineOption opcaoFiltro("filtro", "Roda só os casos cujo nome contém <texto>.", "texto");
+    QCommandLineOption opcaoSaida("saida", "Grava o JSON em <arquivo> em vez da saída padrão.", "arquivo");
+    QCommandLineOption opcaoConferir("conferir", "Só confere os algoritmos de clipping entre si e sai.");
+    parser.addOptions({opcaoMin, opcaoMax, opcaoRepeticoes, opcaoFiltro, opcaoSaida, opcaoConferir});
+    parser.process(aplicacao);
+
+    const QVector<ResultadoAvaliacaoClipping> conferencia = avaliarAlgoritmosClipping(SEGMENTOS_CONFERENCIA);
+    int divergencias = 0;
+    for (const ResultadoAvaliacaoClipping& r : conferencia) {
+        divergencias += r.divergencias;
+    }
+    if (divergencias > 0) {
+        std::fprintf(stderr, "Algoritmos de clipping divergem:\n%s",
+                     qPrintable(formatarAvaliacaoClipping(conferencia, SEGMENTOS_CONFERENCIA)));
+        return 1;
+    }
+    std::fprintf(stderr, "Clipping conferido: %d segmentos, sem divergências.\n", SEGMENTOS_CONFERENCIA);
+    if (parser.isSet(opcaoConferir)) return 0;
+
+    int expoenteMin = std::max(0, parser.value(opcaoMin).toInt());
+    int expoenteMax = std::min(8, parser.value(opcaoMax).toInt());
+    int repeticoes = std::max(1, parser.value(opcaoRepeticoes).toInt());
+
+    QTemporaryDir temporario;
+    if (!temporario.isValid()) {
+        std::fprintf(stderr, "Não foi possível criar um diretório temporário.\n");
+        return 1;
+    }
+
+    Benchmark b(repeticoes, parser.value(opcaoFiltro));
+    for (int e = expoenteMin; e <= expoenteMax; ++e) {
+        int n = static_cast<int>(std::pow(10.0, e));
+        medirMatrizes(b, n);
+        medirTransformacaoObjetos(b, n);
+        medirClipping(b, n);
+        medirArquivos(b, n, temporario);
+        medirCena(b, n);
+        medirPoligonoDenso(b, n);
+    }
+
+    QJsonObject raiz;
+    raiz["formato"] = "projetocg-benchmark";
+    raiz["versao"] = 1;
+    raiz["data"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    raiz["qt"] = QString(qVersion());
+#if defined(__VERSION__)
+    raiz["compilador"] = QString(__VERSION__);
+#endif
+    raiz["cpu"] = QSysInfo::currentCpuArchitecture();
+    raiz["sistema"] = QSysInfo::prettyProductName();
+    raiz["threads"] = QThread::idealThreadCount();
+    raiz["repeticoes"] = repeticoes;
+    raiz["resultados"] = b.getResultados();
+    QByteArray json = QJsonDocument(raiz).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(opcaoSaida)) {
+        QFile arquivo(parser.value(opcaoSaida));
+        if (!arquivo.open(QIODevice::WriteOnly) || arquivo.write(json) != json.size()) {
+            std::fprintf(stderr, "Não foi possível gravar %s\n", qPrintable(parser.value(opcaoSaida)));
+            return 1;
+        }
+    } else {
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+    }
+    return 0;
+}
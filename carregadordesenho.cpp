@@ -0,0 +1,175 @@
+#include "carregadordesenho.h"
+#include "instrumentacao.h"
+#include <QFile>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace {
+// Trechos menores que 2x isso são analisados numa thread só. O carregamento
+// progressivo analisa partes de 16 MB; com blocos mínimos de 1 MB cada parte
+// ainda se divide em até 16 blocos (com 4 MB seriam só 4).
+const qint64 TAMANHO_MINIMO_BLOCO = 1024 * 1024;
+
+struct Bloco {
+    const char* inicio;
+    const char* fim;
+    QVector<double> segmentos;
+};
+
+inline const char* pularEspacos(const char* p, const char* fim) {
+    while (p < fim && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+inline bool lerCaractere(const char*& p, const char* fim, char c) {
+    p = pularEspacos(p, fim);
+    if (p < fim && *p == c) {
+        ++p;
+        return true;
+    }
+    return false;
+}
+
+inline bool lerNumero(const char*& p, const char* fim, double& valor) {
+    p = pularEspacos(p, fim);
+    if (p < fim && *p == '+') ++p; // from_chars não aceita '+'
+    std::from_chars_result r = std::from_chars(p, fim, valor);
+    if (r.ec != std::errc()) return false;
+    // from_chars aceita "inf" e "nan", que a expressão regular antiga recusava.
+    if (!std::isfinite(valor)) return false;
+    p = r.ptr;
+    return true;
+}
+
+inline bool lerPonto(const char*& p, const char* fim, double& x, double& y) {
+    return lerCaractere(p, fim, '(') && lerNumero(p, fim, x) && lerCaractere(p, fim, ',')
+        && lerNumero(p, fim, y) && lerCaractere(p, fim, ')');
+}
+
+// Como a expressão regular antiga, o segmento pode vir depois de outro texto na
+// linha: se a leitura falhar num '(', tenta de novo a partir do '(' seguinte.
+void analisarLinha(const char* p, const char* fim, QVector<double>& saida) {
+    while (true) {
+        while (p < fim && *p != '(' && *p != '#') ++p;
+        if (p == fim || *p == '#') return;
+
+        const char* candidato = p;
+        double x1, y1, x2, y2;
+        if (lerPonto(p, fim, x1, y1) && lerPonto(p, fim, x2, y2)) {
+            saida.append(x1);
+            saida.append(y1);
+            saida.append(x2);
+            saida.append(y2);
+            return;
+        }
+        p = candidato + 1;
+    }
+}
+}
+
+CarregadorDesenho::CarregadorDesenho() {}
+
+void CarregadorDesenho::analisarTrecho(const char* inicio, const char* fim, QVector<double>& saida) {
+    const char* p = inicio;
+    while (p < fim) {
+        const char* fimLinha = static_cast<const char*>(std::memchr(p, '\n', fim - p));
+        if (!fimLinha) fimLinha = fim;
+        analisarLinha(p, fimLinha, saida);
+        p = fimLinha + 1;
+    }
+}
+
+bool CarregadorDesenho::carregar(const QString& caminho) {
+    segmentos.clear();
+    return carregarEmLotes(caminho, [this](const QVector<double>& lote, qint64, qint64) {
+        if (segmentos.isEmpty()) {
+            segmentos = lote;
+        } else {
+            segmentos.append(lote);
+        }
+        return true;
+    }, 0);
+}
+
+bool CarregadorDesenho::carregarEmLotes(const QString& caminho, const ReceptorLote& receber, qint64 tamanhoParte) {
+    erro.clear();
+
+    QFile arquivo(caminho);
+    if (!arquivo.open(QIODevice::ReadOnly)) {
+        erro = "Não foi possível abrir o arquivo selecionado.";
+        return false;
+    }
+    const qint64 tamanho = arquivo.size();
+    if (tamanho == 0) return true;
+
+    const char* dados = reinterpret_cast<const char*>(arquivo.map(0, tamanho));
+    if (!dados) {
+        erro = "Não foi possível mapear o arquivo em memória.";
+        return false;
+    }
+    const char* fim = dados + tamanho;
+    if (tamanhoParte <= 0) tamanhoParte = tamanho;
+
+    bool continuar = true;
+    for (const char* inicioParte = dados; continuar && inicioParte < fim; ) {
+        const char* fimParte = fim;
+        if (fim - inicioParte > tamanhoParte) {
+            const char* quebra = static_cast<const char*>(
+                std::memchr(inicioParte + tamanhoParte, '\n', fim - (inicioParte + tamanhoParte)));
+            fimParte = quebra ? quebra + 1 : fim;
+        }
+
+        QVector<double> lote;
+        {
+            MEDIR_ETAPA("analisar_parte");
+            analisarParalelo(inicioParte, fimParte, lote);
+        }
+        continuar = receber(lote, fimParte - dados, tamanho);
+        inicioParte = fimParte;
+    }
+
+    arquivo.unmap(reinterpret_cast<uchar*>(const_cast<char*>(dados)));
+    if (!continuar) {
+        erro = "Carregamento interrompido.";
+    }
+    return continuar;
+}
+
+void CarregadorDesenho::analisarParalelo(const char* dados, const char* fim, QVector<double>& saida) {
+    const qint64 tamanho = fim - dados;
+
+    // Divide em blocos de tamanho parecido, cada um terminando numa quebra de linha.
+    qint64 numBlocos = std::min<qint64>(QThread::idealThreadCount() * 4, tamanho / TAMANHO_MINIMO_BLOCO);
+    numBlocos = std::max<qint64>(numBlocos, 1);
+    if (numBlocos == 1) {
+        analisarTrecho(dados, fim, saida);
+        return;
+    }
+
+    QVector<Bloco> blocos;
+    blocos.reserve(numBlocos);
+    const char* inicioBloco = dados;
+    for (qint64 i = 1; i <= numBlocos && inicioBloco < fim; ++i) {
+        const char* fimBloco = (i == numBlocos) ? fim : dados + tamanho * i / numBlocos;
+        if (fimBloco < inicioBloco) fimBloco = inicioBloco;
+        const char* quebra = static_cast<const char*>(std::memchr(fimBloco, '\n', fim - fimBloco));
+        fimBloco = quebra ? quebra + 1 : fim;
+        blocos.append({inicioBloco, fimBloco, QVector<double>()});
+        inicioBloco = fimBloco;
+    }
+
+    QtConcurrent::blockingMap(blocos, [](Bloco& b) {
+        // Estimativa grosseira de ~40 bytes por linha para evitar realocações.
+        b.segmentos.reserve((b.fim - b.inicio) / 40 * 4);
+        analisarTrecho(b.inicio, b.fim, b.segmentos);
+    });
+
+    qsizetype total = saida.size();
+    for (const Bloco& b : blocos) total += b.segmentos.size();
+    saida.reserve(total);
+    for (const Bloco& b : blocos) saida.append(b.segmentos);
+}
@@ -0,0 +1,46 @@
+#ifndef CARREGADORDESENHO_H
+#define CARREGADORDESENHO_H
+
+#include <QString>
+#include <QVector>
+#include <functional>
+
+// Lê arquivos de desenho em texto, um segmento por linha no formato
+// "(x1, y1) (x2, y2)". Linhas vazias, linhas que não formam um segmento e tudo
+// após '#' são ignorados; os números aceitam sinal e expoente ("-1.5e3").
+//
+// O arquivo é mapeado em memória e, se for grande, dividido em blocos
+// terminados em '\n' que são analisados em paralelo. A análise não aloca
+// nada por linha: os números são lidos direto dos bytes mapeados.
+class CarregadorDesenho {
+public:
+    // Recebe os segmentos de uma parte do arquivo e quantos bytes já foram lidos;
+    // devolve false para interromper a leitura.
+    typedef std::function<bool(const QVector<double>& segmentos, qint64 bytesLidos, qint64 bytesTotal)> ReceptorLote;
+
+    CarregadorDesenho();
+
+    bool carregar(const QString& caminho);
+
+    // Lê o arquivo em partes de aproximadamente 'tamanhoParte' bytes, entregando
+    // cada uma a 'receber' assim que é analisada. Pode rodar fora da thread da
+    // interface. Não preenche getSegmentos(). Devolve false em erro ou se o
+    // receptor pediu para parar.
+    bool carregarEmLotes(const QString& caminho, const ReceptorLote& receber, qint64 tamanhoParte);
+
+    // Coordenadas na ordem do arquivo: x1, y1, x2, y2 de cada segmento.
+    const QVector<double>& getSegmentos() const { return segmentos; }
+    int getNumSegmentos() const { return segmentos.size() / 4; }
+    QString getErro() const { return erro; }
+
+    // Analisa [inicio, fim) e acrescenta os segmentos encontrados a saida.
+    static void analisarTrecho(const char* inicio, const char* fim, QVector<double>& saida);
+
+private:
+    static void analisarParalelo(const char* inicio, const char* fim, QVector<double>& saida);
+
+    QVector<double> segmentos;
+    QString erro;
+};
+
+#endif // CARREGADORDESENHO_H
@@ -0,0 +1,246 @@
+#include "cenabinaria.h"
+#include <QFile>
+#include <QSaveFile>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace {
+const char MAGICA[8] = {'C', 'G', 'C', 'E', 'N', 'A', 0, 0};
+const quint32 ORDEM_BYTES = 0x01020304;
+
+// Flags do cabeçalho.
+const quint32 CENA_TEM_CAIXAS = 1;
+const quint32 CENA_WINDOW_VISIVEL = 2;
+
+// Flags de cada objeto.
+const quint8 OBJETO_VISIVEL = 1;
+const quint8 OBJETO_PREENCHIDO = 2;
+const quint8 OBJETO_BSPLINE = 4;   // curva: B-spline em vez de Bézier
+
+static_assert(sizeof(CabecalhoCena) == 120, "layout do cabeçalho mudou");
+static_assert(sizeof(RegistroObjeto) == 24, "layout do registro mudou");
+static_assert(sizeof(CaixaLimite) == 4 * sizeof(double), "CaixaLimite deve ser só os 4 doubles");
+
+quint64 alinhar8(quint64 offset) {
+    return (offset + 7) & ~quint64(7);
+}
+
+// Caixa lida do arquivo: finita e com mínimos antes dos máximos. Uma caixa
+// com NaN ou invertida faria o objeto sumir sem aviso no descarte pela window.
+bool caixaValida(const CaixaLimite& c) {
+    return std::isfinite(c.xmin) && std::isfinite(c.ymin) && std::isfinite(c.xmax) && std::isfinite(c.ymax)
+        && c.xmin <= c.xmax && c.ymin <= c.ymax;
+}
+
+// [offset, offset + tamanho) cabe em um arquivo de 'total' bytes, sem estouro.
+bool cabe(quint64 offset, quint64 tamanho, quint64 total) {
+    return offset <= total && tamanho <= total - offset;
+}
+}
+
+bool CenaBinaria::salvar(const QString& caminho, const QVector<ObjetoGrafico*>& objetos, const WindowGrafica* window) {
+    erro.clear();
+
+    QVector<const ObjetoGrafico*> lista;
+    QVector<RegistroObjeto> registros;
+    QByteArray nomes;
+    quint64 numVertices = 0;
+    lista.reserve(objetos.size());
+    registros.reserve(objetos.size());
+
+    for (const ObjetoGrafico* obj : objetos) {
+        if (obj == window) continue;
+        QByteArray nome = obj->getNome().toUtf8();
+        quint8 flags = obj->isVisivel() ? OBJETO_VISIVEL : 0;
+        if (obj->getTipo() == TipoObjeto::POLIGONO && static_cast<const PoligonoGrafico*>(obj)->isPreenchido()) {
+            flags |= OBJETO_PREENCHIDO;
+        }
+        if (obj->getTipo() == TipoObjeto::CURVA
+            && static_cast<const CurvaGrafica*>(obj)->getTipoCurva() == TipoCurva::BSPLINE) {
+            flags |= OBJETO_BSPLINE;
+        }
+        registros.append({static_cast<quint8>(obj->getTipo()), flags, 0,
+                          static_cast<quint32>(obj->getNumPontos()), numVertices,
+                          static_cast<quint32>(nomes.size()), static_cast<quint32>(nome.size())});
+        nomes.append(nome);
+        numVertices += obj->getNumPontos();
+        lista.append(obj);
+    }
+
+    CabecalhoCena c;
+    std::memset(&c, 0, sizeof(c));
+    std::memcpy(c.magica, MAGICA, sizeof(MAGICA));
+    c.versao = VERSAO;
+    c.ordemBytes = ORDEM_BYTES;
+    c.flags = CENA_TEM_CAIXAS | (window->isVisivel() ? CENA_WINDOW_VISIVEL : 0);
+    c.numObjetos = static_cast<quint32>(lista.size());
+    c.numVertices = numVertices;
+    c.offsetObjetos = sizeof(CabecalhoCena);
+    c.offsetNomes = c.offsetObjetos + lista.size() * sizeof(RegistroObjeto);
+    c.tamanhoNomes = nomes.size();
+    c.offsetXs = alinhar8(c.offsetNomes + c.tamanhoNomes);
+    c.offsetYs = c.offsetXs + numVertices * sizeof(double);
+    c.offsetCaixas = c.offsetYs + numVertices * sizeof(double);
+    Ponto centro = window->calcularCentro();
+    c.window[0] = centro.getX();
+    c.window[1] = centro.getY();
+    c.window[2] = window->getLargura();
+    c.window[3] = window->getAltura();
+    c.window[4] = window->getAngulo();
+
+    QSaveFile arquivo(caminho);
+    if (!arquivo.open(QIODevice::WriteOnly)) {
+        erro = "Não foi possível criar o arquivo: " + arquivo.errorString();
+        return false;
+    }
+
+    auto gravar = [&arquivo](const void* dados, qint64 tamanho) {
+        return arquivo.write(static_cast<const char*>(dados), tamanho) == tamanho;
+    };
+
+    const char preenchimento[8] = {0};
+    bool ok = gravar(&c, sizeof(c))
+           && gravar(registros.constData(), registros.size() * sizeof(RegistroObjeto))
+           && gravar(nomes.constData(), nomes.size())
+           && gravar(preenchimento, c.offsetXs - (c.offsetNomes + c.tamanhoNomes));
+    for (int i = 0; ok && i < lista.size(); ++i) {
+        ok = gravar(lista[i]->getXs(), lista[i]->getNumPontos() * sizeof(double));
+    }
+    for (int i = 0; ok && i < lista.size(); ++i) {
+        ok = gravar(lista[i]->getYs(), lista[i]->getNumPontos() * sizeof(double));
+    }
+    for (int i = 0; ok && i < lista.size(); ++i) {
+        ok = gravar(&lista[i]->getCaixa(), sizeof(CaixaLimite));
+    }
+
+    if (!ok || !arquivo.commit()) {
+        erro = "Erro ao gravar a cena: " + arquivo.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool CenaBinaria::carregar(const QString& caminho, ArmazemObjetos* armazem, QVector<ObjetoGrafico*>& objetos,
+                           WindowGrafica* window) {
+    erro.clear();
+
+    QFile arquivo(caminho);
+    if (!arquivo.open(QIODevice::ReadOnly)) {
+        erro = "Não foi possível abrir o arquivo selecionado.";
+        return false;
+    }
+    const quint64 tamanho = arquivo.size();
+    if (tamanho < sizeof(CabecalhoCena)) {
+        erro = "Arquivo de cena inválido.";
+        return false;
+    }
+    const uchar* dados = arquivo.map(0, tamanho);
+    if (!dados) {
+        erro = "Não foi possível mapear o arquivo em memória.";
+        return false;
+    }
+
+    CabecalhoCena c;
+    std::memcpy(&c, dados, sizeof(c));
+
+    bool valido = std::memcmp(c.magica, MAGICA, sizeof(MAGICA)) == 0;
+    if (valido && (c.versao != VERSAO || c.ordemBytes != ORDEM_BYTES)) {
+        erro = QString("Versão ou ordem de bytes da cena não suportada (versão %1).").arg(c.versao);
+        arquivo.unmap(const_cast<uchar*>(dados));
+        return false;
+    }
+    // Armazém e lista de objetos são indexados por int: uma contagem acima
+    // disso viraria negativa nas conversões mais adiante.
+    const quint64 verticesNoArmazem = quint64(armazem->getVertices()->tamanho()) + c.numVertices;
+    if (valido && (verticesNoArmazem > quint64(INT_MAX) || quint64(objetos.size()) + c.numObjetos > quint64(INT_MAX))) {
+        erro = QString("Cena grande demais: %1 vértices e %2 objetos; o limite é %3 de cada.")
+                   .arg(c.numVertices).arg(c.numObjetos).arg(INT_MAX);
+        arquivo.unmap(const_cast<uchar*>(dados));
+        return false;
+    }
+    const quint64 bytesVertices = c.numVertices * sizeof(double);
+    const bool temCaixas = c.flags & CENA_TEM_CAIXAS;
+    valido = valido
+          && c.numVertices <= tamanho / sizeof(double)
+          && c.offsetObjetos % 8 == 0 && c.offsetXs % 8 == 0 && c.offsetYs % 8 == 0 && c.offsetCaixas % 8 == 0
+          && cabe(c.offsetObjetos, quint64(c.numObjetos) * sizeof(RegistroObjeto), tamanho)
+          && cabe(c.offsetNomes, c.tamanhoNomes, tamanho)
+          && cabe(c.offsetXs, bytesVertices, tamanho)
+          && cabe(c.offsetYs, bytesVertices, tamanho)
+          && (!temCaixas || cabe(c.offsetCaixas, quint64(c.numObjetos) * sizeof(CaixaLimite), tamanho));
+
+    // A normalização divide por largura e altura: precisam ser finitas e positivas.
+    for (int i = 0; i < 5; ++i) {
+        valido = valido && std::isfinite(c.window[i]);
+    }
+    valido = valido && c.window[2] > 0.0 && c.window[3] > 0.0;
+
+    const RegistroObjeto* registros = reinterpret_cast<const RegistroObjeto*>(dados + c.offsetObjetos);
+    const char* nomes = reinterpret_cast<const char*>(dados + c.offsetNomes);
+    const double* xs = reinterpret_cast<const double*>(dados + c.offsetXs);
+    const double* ys = reinterpret_cast<const double*>(dados + c.offsetYs);
+    const CaixaLimite* caixas = reinterpret_cast<const CaixaLimite*>(dados + c.offsetCaixas);
+
+    // Tudo é validado antes de criar o primeiro objeto, para não deixar a cena pela metade.
+    for (quint32 i = 0; valido && i < c.numObjetos; ++i) {
+        const RegistroObjeto& r = registros[i];
+        valido = r.primeiroVertice <= c.numVertices && r.numPontos <= c.numVertices - r.primeiroVertice
+              && r.numPontos <= quint32(INT_MAX)
+              && cabe(r.offsetNome, r.tamanhoNome, c.tamanhoNomes)
+              && (!temCaixas || caixaValida(caixas[i]));
+        switch (static_cast<TipoObjeto>(r.tipo)) {
+        case TipoObjeto::PONTO: valido = valido && r.numPontos == 1; break;
+        case TipoObjeto::RETA: valido = valido && r.numPontos == 2; break;
+        case TipoObjeto::POLIGONO: valido = valido && r.numPontos >= 1; break;
+        case TipoObjeto::CURVA:
+            valido = valido && CurvaGrafica::quantidadeValida(
+                r.flags & OBJETO_BSPLINE ? TipoCurva::BSPLINE : TipoCurva::BEZIER, r.numPontos);
+            break;
+        default: valido = false; break;
+        }
+    }
+    if (!valido) {
+        erro = "Arquivo de cena inválido ou corrompido.";
+        arquivo.unmap(const_cast<uchar*>(dados));
+        return false;
+    }
+
+    armazem->getVertices()->reservar(static_cast<int>(c.numVertices));
+    objetos.reserve(objetos.size() + c.numObjetos);
+
+    for (quint32 i = 0; i < c.numObjetos; ++i) {
+        const RegistroObjeto& r = registros[i];
+        const double* x = xs + r.primeiroVertice;
+        const double* y = ys + r.primeiroVertice;
+        QString nome = QString::fromUtf8(nomes + r.offsetNome, r.tamanhoNome);
+
+        ObjetoGrafico* obj = nullptr;
+        switch (static_cast<TipoObjeto>(r.tipo)) {
+        case TipoObjeto::PONTO:
+            obj = armazem->criarPonto(nome, Ponto(x[0], y[0]));
+            break;
+        case TipoObjeto::RETA:
+            obj = armazem->criarReta(nome, Ponto(x[0], y[0]), Ponto(x[1], y[1]));
+            break;
+        case TipoObjeto::POLIGONO:
+            obj = armazem->criarPoligono(nome, x, y, r.numPontos, r.flags & OBJETO_PREENCHIDO);
+            break;
+        case TipoObjeto::CURVA:
+            obj = armazem->criarCurva(nome, r.flags & OBJETO_BSPLINE ? TipoCurva::BSPLINE : TipoCurva::BEZIER,
+                                      x, y, r.numPontos);
+            break;
+        }
+        obj->setVisivel(r.flags & OBJETO_VISIVEL);
+        if (temCaixas) {
+            obj->setCaixa(caixas[i]);
+        }
+        objetos.append(obj);
+    }
+
+    window->definir(c.window[0], c.window[1], c.window[2], c.window[3], c.window[4]);
+    window->setVisivel(c.flags & CENA_WINDOW_VISIVEL);
+
+    arquivo.unmap(const_cast<uchar*>(dados));
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef CENABINARIA_H
+#define CENABINARIA_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include "objetografico.h"
+#include "armazemobjetos.h"
+#include "windowgrafica.h"
+
+// Formato binário da cena (.cgcena). Layout, na ordem de bytes da máquina:
+//
+//   CabecalhoCena
+//   RegistroObjeto[numObjetos]      tipo, flags, faixa de vértices e nome
+//   nomes                           UTF-8, sem terminadores
+//   double xs[numVertices]          alinhado em 8 bytes
+//   double ys[numVertices]
+//   CaixaLimite[numObjetos]         só se CENA_TEM_CAIXAS
+//
+// A leitura mapeia o arquivo e copia os vértices de cada objeto direto para o
+// armazém, sem nenhuma conversão por vértice. A window não entra na tabela de
+// objetos; seus parâmetros de câmera ficam no cabeçalho.
+struct CabecalhoCena {
+    char magica[8];
+    quint32 versao;
+    quint32 ordemBytes;
+    quint32 flags;
+    quint32 numObjetos;
+    quint64 numVertices;
+    quint64 offsetObjetos;
+    quint64 offsetNomes;
+    quint64 tamanhoNomes;
+    quint64 offsetXs;
+    quint64 offsetYs;
+    quint64 offsetCaixas;
+    double window[5]; // centro x, centro y, largura, altura, ângulo
+};
+
+struct RegistroObjeto {
+    quint8 tipo;
+    quint8 flags;
+    quint16 reservado;
+    quint32 numPontos;
+    quint64 primeiroVertice;
+    quint32 offsetNome;
+    quint32 tamanhoNome;
+};
+
+class CenaBinaria {
+public:
+    static const quint32 VERSAO = 1;
+
+    // Grava todos os objetos de 'objetos' exceto 'window'. Os vértices são gravados
+    // como estão no armazém, então os objetos devem estar consolidados.
+    bool salvar(const QString& caminho, const QVector<ObjetoGrafico*>& objetos, const WindowGrafica* window);
+
+    // Cria os objetos lidos no armazém e os acrescenta a 'objetos'; restaura a window.
+    bool carregar(const QString& caminho, ArmazemObjetos* armazem, QVector<ObjetoGrafico*>& objetos,
+                  WindowGrafica* window);
+
+    QString getErro() const { return erro; }
+
+private:
+    QString erro;
+};
+
+#endif // CENABINARIA_H
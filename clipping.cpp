@@ -1,24 +1,107 @@
 #include "clipping.h"
+#include "clippinglote.h"
+#include "instrumentacao.h"
 
-Clipping::Clipping() {}
+Clipping::Clipping() : algoritmo(AlgoritmoClipping::COHEN_SUTHERLAND) {}
+
+void Clipping::setAlgoritmo(AlgoritmoClipping a) {
+    algoritmo = a;
+}
+
+AlgoritmoClipping Clipping::getAlgoritmo() const {
+    return algoritmo;
+}
+
+QString Clipping::nomeAlgoritmo(AlgoritmoClipping a) {
+    switch (a) {
+    case AlgoritmoClipping::COHEN_SUTHERLAND: return "Cohen-Sutherland";
+    case AlgoritmoClipping::LIANG_BARSKY: return "Liang-Barsky";
+    case AlgoritmoClipping::LIANG_BARSKY_LOTE: return QString("Liang-Barsky em lote (%1)").arg(nomeKernelClipping());
+    default: return "Desconhecido";
+    }
+}
 
 int Clipping::computeCode(const Ponto& p, const LimitesWindow& limites) const {
+    return computeCode(p.getX(), p.getY(), limites);
+}
+
+int Clipping::computeCode(double x, double y, const LimitesWindow& limites) const {
     int code = INSIDE;
 
-    if (p.getX() < limites.xmin)
+    if (x < limites.xmin)
         code |= LEFT;
-    else if (p.getX() > limites.xmax)
+    else if (x > limites.xmax)
         code |= RIGHT;
 
-    if (p.getY() < limites.ymin)
+    if (y < limites.ymin)
         code |= BOTTOM;
-    else if (p.getY() > limites.ymax)
+    else if (y > limites.ymax)
         code |= TOP;
 
     return code;
 }
 
 bool Clipping::clipReta(Ponto& p1, Ponto& p2, const LimitesWindow& limites) const {
+    bool aceita = algoritmo == AlgoritmoClipping::COHEN_SUTHERLAND
+                      ? clipRetaCohenSutherland(p1, p2, limites)
+                      : clipRetaLiangBarsky(p1, p2, limites);
+    if (aceita) CONTAR(RETAS_ACEITAS, 1);
+    else CONTAR(RETAS_REJEITADAS, 1);
+    return aceita;
+}
+
+void Clipping::clipRetas(double* x1, double* y1, double* x2, double* y2, int n,
+                         const LimitesWindow& limites, unsigned char* aceito) const {
+    if (algoritmo == AlgoritmoClipping::LIANG_BARSKY_LOTE) {
+        clipRetasLiangBarskyLote(x1, y1, x2, y2, n, limites, aceito);
+        CONTAR_RESULTADOS(RETAS_ACEITAS, RETAS_REJEITADAS, aceito, n);
+        return;
+    }
+    for (int i = 0; i < n; ++i) {
+        Ponto p1(x1[i], y1[i]);
+        Ponto p2(x2[i], y2[i]);
+        aceito[i] = clipReta(p1, p2, limites);
+        x1[i] = p1.getX();
+        y1[i] = p1.getY();
+        x2[i] = p2.getX();
+        y2[i] = p2.getY();
+    }
+}
+
+bool Clipping::clipRetaLiangBarsky(Ponto& p1, Ponto& p2, const LimitesWindow& limites) const {
+    const double dx = p2.getX() - p1.getX();
+    const double dy = p2.getY() - p1.getY();
+    const double p[4] = {-dx, dx, -dy, dy};
+    const double q[4] = {p1.getX() - limites.xmin, limites.xmax - p1.getX(),
+                         p1.getY() - limites.ymin, limites.ymax - p1.getY()};
+    double t0 = 0.0, t1 = 1.0;
+
+    for (int k = 0; k < 4; ++k) {
+        if (p[k] == 0.0) {
+            if (q[k] < 0.0) return false;
+        } else {
+            double r = q[k] / p[k];
+            if (p[k] < 0.0) {
+                if (r > t1) return false;
+                if (r > t0) t0 = r;
+            } else {
+                if (r < t0) return false;
+                if (r < t1) t1 = r;
+            }
+        }
+    }
+
+    const double x0 = p1.getX(), y0 = p1.getY();
+    if (t1 < 1.0) {
+        p2.setX(x0 + t1 * dx);
+        p2.setY(y0 + t1 * dy);
+    }
+    p1.setX(x0 + t0 * dx);
+    p1.setY(y0 + t0 * dy);
+    return true;
+}
+
+bool Clipping::clipRetaCohenSutherland(Ponto& p1, Ponto& p2, const LimitesWindow& limites) const {
     int code1 = computeCode(p1, limites);
     int code2 = computeCode(p2, limites);
     bool aceito = false;
@@ -65,5 +148,107 @@ bool Clipping::clipReta(Ponto& p1, Ponto& p2, const LimitesWindow& limites) cons
 // ==========================================================
 bool Clipping::clipPonto(const Ponto& p, const LimitesWindow& limites) const {
     // Um ponto é visível se e somente se seu código for INSIDE (0)
-    return computeCode(p, limites) == INSIDE;
+    bool visivel = computeCode(p, limites) == INSIDE;
+    if (visivel) CONTAR(PONTOS_ACEITOS, 1);
+    else CONTAR(PONTOS_REJEITADOS, 1);
+    return visivel;
+}
+
+void Clipping::clipPoligono(const double* xs, const double* ys, int n, const LimitesWindow& limites,
+                            PoligonoRecortado& saida, PoligonoRecortado& auxiliar) const {
+    saida.limpar();
+    if (n == 0) return;
+
+    int codeOu = INSIDE;
+    int codeE = LEFT | RIGHT | BOTTOM | TOP;
+    for (int i = 0; i < n; ++i) {
+        int code = computeCode(xs[i], ys[i], limites);
+        codeOu |= code;
+        codeE &= code;
+    }
+
+    // Todos os vértices do mesmo lado de fora: rejeição trivial.
+    if (codeE != 0) return;
+
+    for (int i = 0; i < n; ++i) {
+        saida.adicionar(xs[i], ys[i], false);
+    }
+
+    // Todos dentro: aceitação trivial.
+    if (codeOu == INSIDE) return;
+    CONTAR(POLIGONOS_RECORTADOS, 1);
+
+    static const int bordas[4] = {LEFT, RIGHT, BOTTOM, TOP};
+    for (int borda : bordas) {
+        if (!(codeOu & borda)) continue;
+
+        recortarBorda(saida, auxiliar, borda, limites);
+        saida.x.swap(auxiliar.x);
+        saida.y.swap(auxiliar.y);
+        saida.borda.swap(auxiliar.borda);
+        if (saida.tamanho() == 0) return;
+    }
+}
+
+void Clipping::recortarBorda(const PoligonoRecortado& entrada, PoligonoRecortado& saida,
+                             int borda, const LimitesWindow& limites) const {
+    saida.limpar();
+
+    auto dentro = [borda, &limites](double x, double y) {
+        switch (borda) {
+        case LEFT: return x >= limites.xmin;
+        case RIGHT: return x <= limites.xmax;
+        case BOTTOM: return y >= limites.ymin;
+        default: return y <= limites.ymax;
+        }
+    };
+
+    auto intersecao = [borda, &limites](double sx, double sy, double px, double py, double& ix, double& iy) {
+        switch (borda) {
+        case LEFT:
+            ix = limites.xmin;
+            iy = sy + (py - sy) * (limites.xmin - sx) / (px - sx);
+            break;
+        case RIGHT:
+            ix = limites.xmax;
+            iy = sy + (py - sy) * (limites.xmax - sx) / (px - sx);
+            break;
+        case BOTTOM:
+            ix = sx + (px - sx) * (limites.ymin - sy) / (py - sy);
+            iy = limites.ymin;
+            break;
+        default:
+            ix = sx + (px - sx) * (limites.ymax - sy) / (py - sy);
+            iy = limites.ymax;
+            break;
+        }
+    };
+
+    int m = entrada.tamanho();
+    double sx = entrada.x[m - 1];
+    double sy = entrada.y[m - 1];
+    bool sDentro = dentro(sx, sy);
+
+    for (int i = 0; i < m; ++i) {
+        double px = entrada.x[i];
+        double py = entrada.y[i];
+        bool pDentro = dentro(px, py);
+        double ix, iy;
+
+        if (pDentro) {
+            if (!sDentro) {
+                // Voltando para dentro: a aresta desde o ponto de saída anterior corre sobre a borda.
+                intersecao(sx, sy, px, py, ix, iy);
+                saida.adicionar(ix, iy, true);
+            }
+            saida.adicionar(px, py, entrada.borda[i]);
+        } else if (sDentro) {
+            intersecao(sx, sy, px, py, ix, iy);
+            saida.adicionar(ix, iy, entrada.borda[i]);
+        }
+
+        sx = px;
+        sy = py;
+        sDentro = pDentro;
+    }
 }
@@ -1,13 +1,36 @@
 #ifndef CLIPPING_H
 #define CLIPPING_H
 
+#include <QVector>
 #include "ponto.h"
 #include "windowgrafica.h"
 
+// Polígono produzido pelo recorte. borda[i] indica que a aresta que chega
+// ao vértice i foi criada pelo recorte e corre sobre a borda da window.
+struct PoligonoRecortado {
+    QVector<double> x;
+    QVector<double> y;
+    QVector<bool> borda;
+
+    void limpar() { x.clear(); y.clear(); borda.clear(); }
+    int tamanho() const { return x.size(); }
+    void adicionar(double px, double py, bool arestaBorda) {
+        x.append(px);
+        y.append(py);
+        borda.append(arestaBorda);
+    }
+};
+
+enum class AlgoritmoClipping { COHEN_SUTHERLAND, LIANG_BARSKY, LIANG_BARSKY_LOTE };
+
 class Clipping {
 public:
     Clipping();
 
+    void setAlgoritmo(AlgoritmoClipping algoritmo);
+    AlgoritmoClipping getAlgoritmo() const;
+    static QString nomeAlgoritmo(AlgoritmoClipping algoritmo);
+
     enum RegionCode {
         INSIDE = 0, // 0000
         LEFT = 1,   // 0001
@@ -19,8 +42,29 @@ public:
     bool clipReta(Ponto& p1, Ponto& p2, const LimitesWindow& limites) const;
     bool clipPonto(const Ponto& p, const LimitesWindow& limites) const;
 
+    // Recorta n segmentos guardados em SoA, no próprio lugar; aceito[i] recebe 1
+    // quando o segmento i é visível. Com LIANG_BARSKY_LOTE todos vão de uma vez
+    // para o kernel vetorizado; nos demais algoritmos o recorte é segmento a segmento.
+    void clipRetas(double* x1, double* y1, double* x2, double* y2, int n,
+                   const LimitesWindow& limites, unsigned char* aceito) const;
+
+    // Sutherland-Hodgman. O outcode de cada vértice de entrada é calculado uma
+    // única vez e só as bordas efetivamente cruzadas são processadas.
+    // 'auxiliar' é apenas área de trabalho e pode ser reaproveitado entre chamadas.
+    void clipPoligono(const double* xs, const double* ys, int n, const LimitesWindow& limites,
+                      PoligonoRecortado& saida, PoligonoRecortado& auxiliar) const;
+
 private:
+    bool clipRetaCohenSutherland(Ponto& p1, Ponto& p2, const LimitesWindow& limites) const;
+    bool clipRetaLiangBarsky(Ponto& p1, Ponto& p2, const LimitesWindow& limites) const;
+
     int computeCode(const Ponto& p, const LimitesWindow& limites) const;
+    int computeCode(double x, double y, const LimitesWindow& limites) const;
+
+    void recortarBorda(const PoligonoRecortado& entrada, PoligonoRecortado& saida,
+                       int borda, const LimitesWindow& limites) const;
+
+    AlgoritmoClipping algoritmo;
 };
 
 #endif // CLIPPING_H
@@ -0,0 +1,188 @@
+#include "clippinglote.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define CLIPPING_X86
+#include <immintrin.h>
+#endif
+
+#if defined(CLIPPING_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CLIPPING_AVX2
+#endif
+
+namespace {
+
+typedef void (*KernelClipping)(double* x1, double* y1, double* x2, double* y2, int n,
+                               const LimitesWindow& limites, unsigned char* aceito);
+
+void kernelEscalar(double* x1, double* y1, double* x2, double* y2, int inicio, int n,
+                   const LimitesWindow& l, unsigned char* aceito) {
+    for (int i = inicio; i < n; ++i) {
+        const double dx = x2[i] - x1[i];
+        const double dy = y2[i] - y1[i];
+        const double p[4] = {-dx, dx, -dy, dy};
+        const double q[4] = {x1[i] - l.xmin, l.xmax - x1[i], y1[i] - l.ymin, l.ymax - y1[i]};
+
+        double t0 = 0.0, t1 = 1.0;
+        bool rejeitado = false;
+        for (int k = 0; k < 4; ++k) {
+            if (p[k] == 0.0) {
+                rejeitado |= q[k] < 0.0;
+            } else if (p[k] < 0.0) {
+                t0 = std::max(t0, q[k] / p[k]);
+            } else {
+                t1 = std::min(t1, q[k] / p[k]);
+            }
+        }
+
+        aceito[i] = !rejeitado && t0 <= t1;
+        if (aceito[i]) {
+            const double ox = x1[i], oy = y1[i];
+            if (t1 < 1.0) {
+                x2[i] = ox + t1 * dx;
+                y2[i] = oy + t1 * dy;
+            }
+            x1[i] = ox + t0 * dx;
+            y1[i] = oy + t0 * dy;
+        }
+    }
+}
+
+#ifndef CLIPPING_X86
+void clipEscalar(double* x1, double* y1, double* x2, double* y2, int n,
+                 const LimitesWindow& limites, unsigned char* aceito) {
+    kernelEscalar(x1, y1, x2, y2, 0, n, limites, aceito);
+}
+#else
+// Cada borda contribui com q/p para t0 (p < 0) ou t1 (p > 0); as escolhas
+// são feitas com máscaras em vez de desvios.
+void clipSSE2(double* x1, double* y1, double* x2, double* y2, int n,
+              const LimitesWindow& l, unsigned char* aceito) {
+    const __m128d zero = _mm_setzero_pd(), um = _mm_set1_pd(1.0);
+    const __m128d xmin = _mm_set1_pd(l.xmin), xmax = _mm_set1_pd(l.xmax);
+    const __m128d ymin = _mm_set1_pd(l.ymin), ymax = _mm_set1_pd(l.ymax);
+
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d ax = _mm_loadu_pd(x1 + i), ay = _mm_loadu_pd(y1 + i);
+        const __m128d bx = _mm_loadu_pd(x2 + i), by = _mm_loadu_pd(y2 + i);
+        const __m128d dx = _mm_sub_pd(bx, ax), dy = _mm_sub_pd(by, ay);
+
+        const __m128d p[4] = {_mm_sub_pd(zero, dx), dx, _mm_sub_pd(zero, dy), dy};
+        const __m128d q[4] = {_mm_sub_pd(ax, xmin), _mm_sub_pd(xmax, ax),
+                              _mm_sub_pd(ay, ymin), _mm_sub_pd(ymax, ay)};
+
+        __m128d t0 = zero, t1 = um, rejeitado = zero;
+        for (int k = 0; k < 4; ++k) {
+            const __m128d r = _mm_div_pd(q[k], p[k]);
+            const __m128d neg = _mm_cmplt_pd(p[k], zero);
+            const __m128d pos = _mm_cmpgt_pd(p[k], zero);
+            const __m128d paralela = _mm_cmpeq_pd(p[k], zero);
+            rejeitado = _mm_or_pd(rejeitado, _mm_and_pd(paralela, _mm_cmplt_pd(q[k], zero)));
+            t0 = _mm_or_pd(_mm_andnot_pd(neg, t0), _mm_and_pd(neg, _mm_max_pd(t0, r)));
+            t1 = _mm_or_pd(_mm_andnot_pd(pos, t1), _mm_and_pd(pos, _mm_min_pd(t1, r)));
+        }
+
+        const __m128d ok = _mm_andnot_pd(rejeitado, _mm_cmple_pd(t0, t1));
+        const __m128d fim = _mm_cmplt_pd(t1, um);
+        const __m128d nx2 = _mm_add_pd(ax, _mm_mul_pd(t1, dx));
+        const __m128d ny2 = _mm_add_pd(ay, _mm_mul_pd(t1, dy));
+        const __m128d nx1 = _mm_add_pd(ax, _mm_mul_pd(t0, dx));
+        const __m128d ny1 = _mm_add_pd(ay, _mm_mul_pd(t0, dy));
+
+        const __m128d trocaFim = _mm_and_pd(ok, fim);
+        _mm_storeu_pd(x1 + i, _mm_or_pd(_mm_andnot_pd(ok, ax), _mm_and_pd(ok, nx1)));
+        _mm_storeu_pd(y1 + i, _mm_or_pd(_mm_andnot_pd(ok, ay), _mm_and_pd(ok, ny1)));
+        _mm_storeu_pd(x2 + i, _mm_or_pd(_mm_andnot_pd(trocaFim, bx), _mm_and_pd(trocaFim, nx2)));
+        _mm_storeu_pd(y2 + i, _mm_or_pd(_mm_andnot_pd(trocaFim, by), _mm_and_pd(trocaFim, ny2)));
+
+        const int mascara = _mm_movemask_pd(ok);
+        aceito[i] = mascara & 1;
+        aceito[i + 1] = (mascara >> 1) & 1;
+    }
+    kernelEscalar(x1, y1, x2, y2, i, n, l, aceito);
+}
+#endif
+
+#ifdef CLIPPING_AVX2
+__attribute__((target("avx2")))
+void clipAVX2(double* x1, double* y1, double* x2, double* y2, int n,
+              const LimitesWindow& l, unsigned char* aceito) {
+    const __m256d zero = _mm256_setzero_pd(), um = _mm256_set1_pd(1.0);
+    const __m256d xmin = _mm256_set1_pd(l.xmin), xmax = _mm256_set1_pd(l.xmax);
+    const __m256d ymin = _mm256_set1_pd(l.ymin), ymax = _mm256_set1_pd(l.ymax);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d ax = _mm256_loadu_pd(x1 + i), ay = _mm256_loadu_pd(y1 + i);
+        const __m256d bx = _mm256_loadu_pd(x2 + i), by = _mm256_loadu_pd(y2 + i);
+        const __m256d dx = _mm256_sub_pd(bx, ax), dy = _mm256_sub_pd(by, ay);
+
+        const __m256d p[4] = {_mm256_sub_pd(zero, dx), dx, _mm256_sub_pd(zero, dy), dy};
+        const __m256d q[4] = {_mm256_sub_pd(ax, xmin), _mm256_sub_pd(xmax, ax),
+                              _mm256_sub_pd(ay, ymin), _mm256_sub_pd(ymax, ay)};
+
+        __m256d t0 = zero, t1 = um, rejeitado = zero;
+        for (int k = 0; k < 4; ++k) {
+            const __m256d r = _mm256_div_pd(q[k], p[k]);
+            const __m256d neg = _mm256_cmp_pd(p[k], zero, _CMP_LT_OQ);
+            const __m256d pos = _mm256_cmp_pd(p[k], zero, _CMP_GT_OQ);
+            const __m256d paralela = _mm256_cmp_pd(p[k], zero, _CMP_EQ_OQ);
+            rejeitado = _mm256_or_pd(rejeitado, _mm256_and_pd(paralela, _mm256_cmp_pd(q[k], zero, _CMP_LT_OQ)));
+            t0 = _mm256_blendv_pd(t0, _mm256_max_pd(t0, r), neg);
+            t1 = _mm256_blendv_pd(t1, _mm256_min_pd(t1, r), pos);
+        }
+
+        const __m256d ok = _mm256_andnot_pd(rejeitado, _mm256_cmp_pd(t0, t1, _CMP_LE_OQ));
+        const __m256d trocaFim = _mm256_and_pd(ok, _mm256_cmp_pd(t1, um, _CMP_LT_OQ));
+
+        _mm256_storeu_pd(x1 + i, _mm256_blendv_pd(ax, _mm256_add_pd(ax, _mm256_mul_pd(t0, dx)), ok));
+        _mm256_storeu_pd(y1 + i, _mm256_blendv_pd(ay, _mm256_add_pd(ay, _mm256_mul_pd(t0, dy)), ok));
+        _mm256_storeu_pd(x2 + i, _mm256_blendv_pd(bx, _mm256_add_pd(ax, _mm256_mul_pd(t1, dx)), trocaFim));
+        _mm256_storeu_pd(y2 + i, _mm256_blendv_pd(by, _mm256_add_pd(ay, _mm256_mul_pd(t1, dy)), trocaFim));
+
+        const int mascara = _mm256_movemask_pd(ok);
+        aceito[i] = mascara & 1;
+        aceito[i + 1] = (mascara >> 1) & 1;
+        aceito[i + 2] = (mascara >> 2) & 1;
+        aceito[i + 3] = (mascara >> 3) & 1;
+    }
+    kernelEscalar(x1, y1, x2, y2, i, n, l, aceito);
+}
+#endif
+
+struct Despacho {
+    KernelClipping kernel;
+    const char* nome;
+};
+
+Despacho escolherKernel() {
+#ifdef CLIPPING_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {clipAVX2, "AVX2"};
+    }
+#endif
+#ifdef CLIPPING_X86
+    return {clipSSE2, "SSE2"};
+#else
+    return {clipEscalar, "Escalar"};
+#endif
+}
+
+const Despacho& despacho() {
+    static const Despacho escolhido = escolherKernel();
+    return escolhido;
+}
+
+} // namespace
+
+void clipRetasLiangBarskyLote(double* x1, double* y1, double* x2, double* y2, int n,
+                              const LimitesWindow& limites, unsigned char* aceito) {
+    if (n <= 0) return;
+    despacho().kernel(x1, y1, x2, y2, n, limites, aceito);
+}
+
+const char* nomeKernelClipping() {
+    return despacho().nome;
+}
@@ -0,0 +1,15 @@
+#ifndef CLIPPINGLOTE_H
+#define CLIPPINGLOTE_H
+
+#include "windowgrafica.h"
+
+// Liang-Barsky sem desvios sobre n segmentos em SoA (x1[], y1[], x2[], y2[]).
+// Os segmentos são recortados no próprio lugar e aceito[i] recebe 1 quando o
+// segmento i tem alguma parte visível. Como em transformarLote, a versão
+// (AVX2, SSE2 ou escalar) é escolhida em tempo de execução.
+void clipRetasLiangBarskyLote(double* x1, double* y1, double* x2, double* y2, int n,
+                              const LimitesWindow& limites, unsigned char* aceito);
+
+const char* nomeKernelClipping();
+
+#endif // CLIPPINGLOTE_H
@@ -0,0 +1,205 @@
+#include "gradeespacial.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const qint64 MAX_CELULAS_POR_OBJETO = 1024;
+const double LIMITE_INDICE = 1 << 30;
+
+int indiceCelula(double coordenada, double tamanhoCelula) {
+    double c = std::floor(coordenada / tamanhoCelula);
+    c = std::max(-LIMITE_INDICE, std::min(LIMITE_INDICE, c));
+    return static_cast<int>(c);
+}
+
+// Quantidade de células em [cx0, cx1] x [cy0, cy1]. Os índices vão até ±2^30,
+// então a largura de uma faixa já não cabe em int: tudo é feito em 64 bits.
+qint64 contarCelulas(int cx0, int cy0, int cx1, int cy1) {
+    return (static_cast<qint64>(cx1) - cx0 + 1) * (static_cast<qint64>(cy1) - cy0 + 1);
+}
+
+// Célula do nível k que contém a célula c do nível 0 (divisão por 2^k arredondada para baixo).
+int celulaNivel(int c, int k) {
+    return c >= 0 ? (c >> k) : -((-c - 1) >> k) - 1;
+}
+}
+
+GradeEspacial::GradeEspacial(double tamanhoCelula) : tamanhoCelula(tamanhoCelula) {}
+
+quint64 GradeEspacial::chave(int cx, int cy) {
+    return (static_cast<quint64>(static_cast<quint32>(cx)) << 32) | static_cast<quint32>(cy);
+}
+
+GradeEspacial::Faixa GradeEspacial::calcularFaixa(const CaixaLimite& caixa) const {
+    Faixa f;
+    f.cx0 = indiceCelula(caixa.xmin, tamanhoCelula);
+    f.cy0 = indiceCelula(caixa.ymin, tamanhoCelula);
+    f.cx1 = indiceCelula(caixa.xmax, tamanhoCelula);
+    f.cy1 = indiceCelula(caixa.ymax, tamanhoCelula);
+    qint64 numCelulas = contarCelulas(f.cx0, f.cy0, f.cx1, f.cy1);
+    f.grande = numCelulas > MAX_CELULAS_POR_OBJETO;
+    f.pequeno = numCelulas == 1;
+    f.contado = false;
+    return f;
+}
+
+void GradeEspacial::contar(int cx, int cy, int delta) {
+    for (int k = 0; k < NUM_NIVEIS; ++k) {
+        quint64 c = chave(celulaNivel(cx, k), celulaNivel(cy, k));
+        int& n = ocupacao[k][c];
+        n += delta;
+        if (n == 0) {
+            ocupacao[k].remove(c);
+        }
+    }
+}
+
+void GradeEspacial::inserir(ObjetoGrafico* obj) {
+    obj->atualizarCaches();
+    const CaixaLimite& caixa = obj->getCaixa();
+    Faixa f = calcularFaixa(caixa);
+    f.pequeno = f.pequeno && obj->getTipo() != TipoObjeto::PONTO;
+    f.contado = f.pequeno && obj->isVisivel();
+    entradas.insert(obj, f);
+
+    Item item = {obj, caixa, f.cx0, f.cy0};
+    if (f.grande) {
+        grandes.append(item);
+        return;
+    }
+    if (f.pequeno) {
+        celulas[chave(f.cx0, f.cy0)].pequenos.append(item);
+        if (f.contado) contar(f.cx0, f.cy0, 1);
+        return;
+    }
+    for (int cy = f.cy0; cy <= f.cy1; ++cy) {
+        for (int cx = f.cx0; cx <= f.cx1; ++cx) {
+            celulas[chave(cx, cy)].itens.append(item);
+        }
+    }
+}
+
+void GradeEspacial::remover(ObjetoGrafico* obj) {
+    auto it = entradas.find(obj);
+    if (it == entradas.end()) return;
+    Faixa f = it.value();
+    entradas.erase(it);
+
+    auto removerDe = [obj](QVector<Item>& itens) {
+        for (int i = 0; i < itens.size(); ++i) {
+            if (itens[i].obj == obj) {
+                itens[i] = itens.last();
+                itens.removeLast();
+                return;
+            }
+        }
+    };
+
+    if (f.grande) {
+        removerDe(grandes);
+        return;
+    }
+    if (f.contado) contar(f.cx0, f.cy0, -1);
+    for (int cy = f.cy0; cy <= f.cy1; ++cy) {
+        for (int cx = f.cx0; cx <= f.cx1; ++cx) {
+            auto celula = celulas.find(chave(cx, cy));
+            if (celula == celulas.end()) continue;
+            removerDe(f.pequeno ? celula.value().pequenos : celula.value().itens);
+            if (celula.value().itens.isEmpty() && celula.value().pequenos.isEmpty()) {
+                celulas.erase(celula);
+            }
+        }
+    }
+}
+
+void GradeEspacial::atualizar(ObjetoGrafico* obj) {
+    remover(obj);
+    inserir(obj);
+}
+
+void GradeEspacial::limpar() {
+    celulas.clear();
+    entradas.clear();
+    grandes.clear();
+    for (QHash<quint64, int>& nivel : ocupacao) {
+        nivel.clear();
+    }
+}
+
+void GradeEspacial::coletar(const Celula& celula, int cx, int cy, const Faixa& consulta, const CaixaLimite& regiao,
+                            bool incluirPequenos, QVector<ObjetoGrafico*>& resultado) const {
+    if (incluirPequenos) {
+        // Pequenos só existem em uma célula, então nunca se repetem.
+        for (const Item& item : celula.pequenos) {
+            if (item.caixa.intersecta(regiao)) {
+                resultado.append(item.obj);
+            }
+        }
+    }
+    for (const Item& item : celula.itens) {
+        // Um objeto que ocupa várias células só é reportado pela primeira
+        // célula comum a ele e à consulta.
+        if (cx != std::max(item.cx0, consulta.cx0) || cy != std::max(item.cy0, consulta.cy0)) continue;
+        if (item.caixa.intersecta(regiao)) {
+            resultado.append(item.obj);
+        }
+    }
+}
+
+void GradeEspacial::consultar(const CaixaLimite& regiao, QVector<ObjetoGrafico*>& resultado,
+                              bool incluirPequenos) const {
+    Faixa consulta = calcularFaixa(regiao);
+    qint64 celulasConsulta = contarCelulas(consulta.cx0, consulta.cy0, consulta.cx1, consulta.cy1);
+
+    if (celulasConsulta > celulas.size()) {
+        // Região maior que a parte ocupada da grade: percorre só as células existentes.
+        for (auto it = celulas.constBegin(); it != celulas.constEnd(); ++it) {
+            int cx = static_cast<int>(static_cast<quint32>(it.key() >> 32));
+            int cy = static_cast<int>(static_cast<quint32>(it.key()));
+            if (cx < consulta.cx0 || cx > consulta.cx1 || cy < consulta.cy0 || cy > consulta.cy1) continue;
+            coletar(it.value(), cx, cy, consulta, regiao, incluirPequenos, resultado);
+        }
+    } else {
+        for (int cy = consulta.cy0; cy <= consulta.cy1; ++cy) {
+            for (int cx = consulta.cx0; cx <= consulta.cx1; ++cx) {
+                auto celula = celulas.constFind(chave(cx, cy));
+                if (celula == celulas.constEnd()) continue;
+                coletar(celula.value(), cx, cy, consulta, regiao, incluirPequenos, resultado);
+            }
+        }
+    }
+
+    for (const Item& item : grandes) {
+        if (item.caixa.intersecta(regiao)) {
+            resultado.append(item.obj);
+        }
+    }
+}
+
+void GradeEspacial::consultarOcupacao(const CaixaLimite& regiao, int nivel, QVector<CaixaLimite>& resultado) const {
+    nivel = std::max(0, std::min(NUM_NIVEIS - 1, nivel));
+    const double lado = tamanhoCelula * (1 << nivel);
+    const QHash<quint64, int>& ocupadas = ocupacao[nivel];
+
+    int cx0 = indiceCelula(regiao.xmin, lado), cy0 = indiceCelula(regiao.ymin, lado);
+    int cx1 = indiceCelula(regiao.xmax, lado), cy1 = indiceCelula(regiao.ymax, lado);
+    auto emitir = [&](int cx, int cy) {
+        resultado.append({cx * lado, cy * lado, (cx + 1) * lado, (cy + 1) * lado});
+    };
+
+    qint64 celulasConsulta = contarCelulas(cx0, cy0, cx1, cy1);
+    if (celulasConsulta > ocupadas.size()) {
+        for (auto it = ocupadas.constBegin(); it != ocupadas.constEnd(); ++it) {
+            int cx = static_cast<int>(static_cast<quint32>(it.key() >> 32));
+            int cy = static_cast<int>(static_cast<quint32>(it.key()));
+            if (cx < cx0 || cx > cx1 || cy < cy0 || cy > cy1) continue;
+            emitir(cx, cy);
+        }
+    } else {
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                if (ocupadas.contains(chave(cx, cy))) emitir(cx, cy);
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef GRADEESPACIAL_H
+#define GRADEESPACIAL_H
+
+#include <QHash>
+#include <QVector>
+#include "objetografico.h"
+
+// Índice espacial em grade uniforme sobre as caixas dos objetos (em
+// coordenadas do mundo). Cada célula lista os objetos que a tocam; uma
+// consulta visita só as células da região pedida.
+//
+// Objetos pequenos (cabem numa célula; pontos não contam) ficam numa lista à
+// parte em cada célula e, se visíveis, são contados numa pirâmide de ocupação:
+// no nível k as células têm lado tamanhoCelula * 2^k. Com a window muito
+// afastada, a renderização desenha um ponto por célula ocupada em vez de
+// visitar esses objetos um a um.
+class GradeEspacial {
+public:
+    static const int NUM_NIVEIS = 12;
+
+    explicit GradeEspacial(double tamanhoCelula = 64.0);
+
+    void inserir(ObjetoGrafico* obj);
+    void remover(ObjetoGrafico* obj);
+    void atualizar(ObjetoGrafico* obj);
+    void limpar();
+
+    // Acrescenta a resultado cada objeto cuja caixa toca a região, uma única vez.
+    // Com incluirPequenos = false os objetos contados na pirâmide são pulados.
+    // As consultas só leem a grade, então podem ser feitas de várias threads ao mesmo tempo.
+    void consultar(const CaixaLimite& regiao, QVector<ObjetoGrafico*>& resultado,
+                   bool incluirPequenos = true) const;
+
+    // Acrescenta a resultado a caixa de cada célula ocupada do nível que toca a região.
+    void consultarOcupacao(const CaixaLimite& regiao, int nivel, QVector<CaixaLimite>& resultado) const;
+
+    double getTamanhoCelula() const { return tamanhoCelula; }
+    int tamanho() const { return entradas.size(); }
+
+private:
+    struct Item {
+        ObjetoGrafico* obj;
+        CaixaLimite caixa;
+        int cx0, cy0; // primeira célula ocupada, usada para não repetir o objeto
+    };
+
+    struct Faixa {
+        int cx0, cy0, cx1, cy1;
+        bool grande;
+        bool pequeno;
+        bool contado; // entrou na pirâmide de ocupação
+    };
+
+    struct Celula {
+        QVector<Item> itens;
+        QVector<Item> pequenos;
+    };
+
+    Faixa calcularFaixa(const CaixaLimite& caixa) const;
+    static quint64 chave(int cx, int cy);
+    void coletar(const Celula& celula, int cx, int cy, const Faixa& consulta, const CaixaLimite& regiao,
+                 bool incluirPequenos, QVector<ObjetoGrafico*>& resultado) const;
+    void contar(int cx, int cy, int delta);
+
+    double tamanhoCelula;
+    QHash<quint64, Celula> celulas;
+    QHash<ObjetoGrafico*, Faixa> entradas;
+    QHash<quint64, int> ocupacao[NUM_NIVEIS];
+
+    // Objetos que cobririam células demais ficam fora da grade e são testados sempre.
+    QVector<Item> grandes;
+};
+
+#endif // GRADEESPACIAL_H
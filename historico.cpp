@@ -0,0 +1,195 @@
+#include "historico.h"
+#include <QtAlgorithms>
+
+Comando::Comando() : temHandle(false), handle{TipoObjeto::PONTO, 0, 0} {}
+
+Comando::Comando(const HandleObjeto& handle) : temHandle(true), handle(handle) {}
+
+bool Comando::getHandle(HandleObjeto& h) const {
+    if (temHandle) h = handle;
+    return temHandle;
+}
+
+ComandoTransformacao::ComandoTransformacao(const HandleObjeto& handle, const Mat3& matriz, const QString& descricao)
+    : Comando(handle), matriz(matriz), texto(descricao)
+{}
+
+void ComandoTransformacao::desfazer(CenaHistorico& cena) {
+    // Transformações singulares (escala zero) não chegam a ser registradas.
+    Mat3 inversa;
+    ObjetoGrafico* obj = cena.objetoDoHandle(handle);
+    if (obj && matriz.inversa(inversa)) {
+        cena.transformarObjeto(obj, inversa);
+    }
+}
+
+void ComandoTransformacao::refazer(CenaHistorico& cena) {
+    if (ObjetoGrafico* obj = cena.objetoDoHandle(handle)) {
+        cena.transformarObjeto(obj, matriz);
+    }
+}
+
+ComandoWindow::ComandoWindow(const EstadoWindow& antes, const EstadoWindow& depois)
+    : antes(antes), depois(depois)
+{}
+
+void ComandoWindow::desfazer(CenaHistorico& cena) {
+    cena.definirWindow(antes);
+}
+
+void ComandoWindow::refazer(CenaHistorico& cena) {
+    cena.definirWindow(depois);
+}
+
+ComandoVisibilidade::ComandoVisibilidade(const HandleObjeto& handle, bool visivel)
+    : Comando(handle), visivel(visivel)
+{}
+
+void ComandoVisibilidade::desfazer(CenaHistorico& cena) {
+    if (ObjetoGrafico* obj = cena.objetoDoHandle(handle)) {
+        cena.definirVisibilidade(obj, !visivel);
+    }
+}
+
+void ComandoVisibilidade::refazer(CenaHistorico& cena) {
+    if (ObjetoGrafico* obj = cena.objetoDoHandle(handle)) {
+        cena.definirVisibilidade(obj, visivel);
+    }
+}
+
+ComandoExistencia::ComandoExistencia(const HandleObjeto& handle)
+    : Comando(handle), criacao(true), copia(nullptr)
+{}
+
+ComandoExistencia::ComandoExistencia(const HandleObjeto& handle, const CopiaObjeto& copia)
+    : Comando(handle), criacao(false), copia(new CopiaObjeto(copia))
+{}
+
+ComandoExistencia::~ComandoExistencia() {
+    delete copia;
+}
+
+void ComandoExistencia::desfazer(CenaHistorico& cena) {
+    if (criacao) remover(cena);
+    else restaurar(cena);
+}
+
+void ComandoExistencia::refazer(CenaHistorico& cena) {
+    if (criacao) restaurar(cena);
+    else remover(cena);
+}
+
+void ComandoExistencia::remover(CenaHistorico& cena) {
+    ObjetoGrafico* obj = cena.objetoDoHandle(handle);
+    if (!obj || copia) return;
+    copia = new CopiaObjeto(cena.removerObjeto(obj));
+}
+
+void ComandoExistencia::restaurar(CenaHistorico& cena) {
+    if (!copia) return;
+    handle = cena.restaurarObjeto(*copia);
+    delete copia;
+    copia = nullptr;
+}
+
+qint64 ComandoExistencia::tamanhoBytes() const {
+    qint64 total = sizeof(*this);
+    if (copia) {
+        total += sizeof(CopiaObjeto)
+               + (copia->xs.capacity() + copia->ys.capacity()) * qint64(sizeof(double))
+               + copia->nome.capacity() * qint64(sizeof(QChar));
+    }
+    return total;
+}
+
+Historico::Historico(qint64 limiteBytes)
+    : atual(0), limiteBytes(limiteBytes), tamanhoBytes(0)
+{}
+
+Historico::~Historico() {
+    limpar();
+}
+
+void Historico::limpar() {
+    qDeleteAll(comandos);
+    comandos.clear();
+    atual = 0;
+    tamanhoBytes = 0;
+}
+
+void Historico::registrar(Comando* comando) {
+    while (comandos.size() > atual) {
+        Comando* descartado = comandos.takeLast();
+        tamanhoBytes -= descartado->tamanhoBytes();
+        delete descartado;
+    }
+    comandos.append(comando);
+    tamanhoBytes += comando->tamanhoBytes();
+    ++atual;
+    aplicarLimite();
+}
+
+template <typename Acao>
+void Historico::executar(Comando* comando, Acao acao) {
+    HandleObjeto antes, depois;
+    bool temHandle = comando->getHandle(antes);
+    tamanhoBytes -= comando->tamanhoBytes();
+    acao(comando);
+    tamanhoBytes += comando->tamanhoBytes();
+
+    // Um objeto recriado ganha outro handle; os demais comandos sobre ele passam a usá-lo.
+    if (temHandle && comando->getHandle(depois) && depois != antes) {
+        remapear(antes, depois);
+    }
+}
+
+bool Historico::desfazer(CenaHistorico& cena) {
+    if (!podeDesfazer()) return false;
+    --atual;
+    executar(comandos[atual], [&cena](Comando* c) { c->desfazer(cena); });
+    aplicarLimite();
+    return true;
+}
+
+bool Historico::refazer(CenaHistorico& cena) {
+    if (!podeRefazer()) return false;
+    executar(comandos[atual], [&cena](Comando* c) { c->refazer(cena); });
+    ++atual;
+    aplicarLimite();
+    return true;
+}
+
+QString Historico::proximoDesfazer() const {
+    return podeDesfazer() ? comandos[atual - 1]->descricao() : QString();
+}
+
+QString Historico::proximoRefazer() const {
+    return podeRefazer() ? comandos[atual]->descricao() : QString();
+}
+
+void Historico::setLimiteBytes(qint64 limite) {
+    limiteBytes = limite;
+    aplicarLimite();
+}
+
+void Historico::remapear(const HandleObjeto& antigo, const HandleObjeto& novo) {
+    for (Comando* c : comandos) {
+        if (c->refereA(antigo)) c->trocarHandle(novo);
+    }
+}
+
+void Historico::aplicarLimite() {
+    // Primeiro o que só poderia ser refeito, do mais novo para o mais velho;
+    // depois o que poderia ser desfeito, do mais velho para o mais novo.
+    while (tamanhoBytes > limiteBytes && comandos.size() > atual && comandos.size() > 1) {
+        Comando* c = comandos.takeLast();
+        tamanhoBytes -= c->tamanhoBytes();
+        delete c;
+    }
+    while (tamanhoBytes > limiteBytes && comandos.size() > 1) {
+        Comando* c = comandos.takeFirst();
+        tamanhoBytes -= c->tamanhoBytes();
+        delete c;
+        --atual;
+    }
+}
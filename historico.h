@@ -0,0 +1,179 @@
+#ifndef HISTORICO_H
+#define HISTORICO_H
+
+#include <QString>
+#include <QVector>
+#include "armazemobjetos.h"
+#include "matrix.h"
+
+// Parâmetros da window e a viewport onde ela é mostrada ("Aplicar" muda as
+// duas juntas); guardar e restaurar custa o mesmo que a própria navegação.
+struct EstadoWindow {
+    double centroX, centroY;
+    double largura, altura;
+    double angulo;
+    int viewport[4];  // xmin, ymin, xmax, ymax, em pixels
+};
+
+// O necessário para recriar um objeto que saiu da cena.
+struct CopiaObjeto {
+    TipoObjeto tipo;
+    TipoCurva tipoCurva;
+    QString nome;
+    QVector<double> xs;  // em coordenadas do objeto
+    QVector<double> ys;
+    bool temModelo;
+    Mat3 modelo;
+    bool preenchido;
+    bool visivel;
+    int linha;           // posição no display file
+};
+
+// O que os comandos precisam da cena. A MainWindow implementa, mantendo
+// display file, grade, lista e canvas coerentes a cada operação.
+class CenaHistorico {
+public:
+    virtual ~CenaHistorico() {}
+
+    virtual ObjetoGrafico* objetoDoHandle(const HandleObjeto& h) const = 0;
+    virtual void transformarObjeto(ObjetoGrafico* obj, const Mat3& matriz) = 0;
+    virtual void definirVisibilidade(ObjetoGrafico* obj, bool visivel) = 0;
+    virtual void definirWindow(const EstadoWindow& estado) = 0;
+    // Copia o objeto e o destrói.
+    virtual CopiaObjeto removerObjeto(ObjetoGrafico* obj) = 0;
+    // Cria o objeto de novo; o handle antigo não volta a valer.
+    virtual HandleObjeto restaurarObjeto(const CopiaObjeto& copia) = 0;
+};
+
+// Operação já executada que sabe se desfazer e se refazer. Guarda só o que
+// não dá para deduzir da cena: a matriz de uma transformação (desfeita pela
+// inversa), o handle e o valor de uma visibilidade, a cópia de um objeto
+// apenas enquanto ele está fora da cena.
+class Comando {
+public:
+    Comando();
+    explicit Comando(const HandleObjeto& handle);
+    virtual ~Comando() {}
+
+    virtual void desfazer(CenaHistorico& cena) = 0;
+    virtual void refazer(CenaHistorico& cena) = 0;
+    // Memória ocupada, incluindo cópias guardadas; muda quando uma cópia é feita ou liberada.
+    virtual qint64 tamanhoBytes() const = 0;
+    virtual QString descricao() const = 0;
+
+    bool refereA(const HandleObjeto& h) const { return temHandle && handle == h; }
+    void trocarHandle(const HandleObjeto& novo) { handle = novo; }
+    bool getHandle(HandleObjeto& h) const;
+
+protected:
+    bool temHandle;
+    HandleObjeto handle;
+};
+
+class ComandoTransformacao : public Comando {
+public:
+    ComandoTransformacao(const HandleObjeto& handle, const Mat3& matriz, const QString& descricao);
+
+    void desfazer(CenaHistorico& cena) override;
+    void refazer(CenaHistorico& cena) override;
+    qint64 tamanhoBytes() const override { return sizeof(*this); }
+    QString descricao() const override { return texto; }
+
+private:
+    Mat3 matriz;
+    QString texto;
+};
+
+class ComandoWindow : public Comando {
+public:
+    ComandoWindow(const EstadoWindow& antes, const EstadoWindow& depois);
+
+    void desfazer(CenaHistorico& cena) override;
+    void refazer(CenaHistorico& cena) override;
+    qint64 tamanhoBytes() const override { return sizeof(*this); }
+    QString descricao() const override { return "Navegar na window/viewport"; }
+
+private:
+    EstadoWindow antes;
+    EstadoWindow depois;
+};
+
+class ComandoVisibilidade : public Comando {
+public:
+    ComandoVisibilidade(const HandleObjeto& handle, bool visivel);
+
+    void desfazer(CenaHistorico& cena) override;
+    void refazer(CenaHistorico& cena) override;
+    qint64 tamanhoBytes() const override { return sizeof(*this); }
+    QString descricao() const override { return visivel ? "Mostrar objeto" : "Ocultar objeto"; }
+
+private:
+    bool visivel;  // valor depois da operação
+};
+
+// Criação ou exclusão de um objeto: uma desfaz a outra. A cópia só existe
+// enquanto o objeto está fora da cena.
+class ComandoExistencia : public Comando {
+public:
+    // Criação: o objeto de 'handle' acabou de entrar na cena.
+    explicit ComandoExistencia(const HandleObjeto& handle);
+    // Exclusão: o objeto de 'handle' já foi removido e 'copia' o descreve.
+    ComandoExistencia(const HandleObjeto& handle, const CopiaObjeto& copia);
+    ~ComandoExistencia() override;
+
+    void desfazer(CenaHistorico& cena) override;
+    void refazer(CenaHistorico& cena) override;
+    qint64 tamanhoBytes() const override;
+    QString descricao() const override { return criacao ? "Criar objeto" : "Excluir objeto"; }
+
+private:
+    void remover(CenaHistorico& cena);
+    void restaurar(CenaHistorico& cena);
+
+    bool criacao;
+    CopiaObjeto* copia;
+};
+
+// Pilha de desfazer/refazer com limite de memória. Ao passar do limite os
+// comandos mais antigos são descartados (o mais recente fica sempre).
+class Historico {
+public:
+    static constexpr qint64 LIMITE_PADRAO = 64 * 1024 * 1024;
+
+    explicit Historico(qint64 limiteBytes = LIMITE_PADRAO);
+    ~Historico();
+    Historico(const Historico&) = delete;
+    Historico& operator=(const Historico&) = delete;
+
+    // 'comando' já foi executado; o histórico passa a ser o dono. Descarta o
+    // que podia ser refeito.
+    void registrar(Comando* comando);
+    bool desfazer(CenaHistorico& cena);
+    bool refazer(CenaHistorico& cena);
+    void limpar();
+
+    bool podeDesfazer() const { return atual > 0; }
+    bool podeRefazer() const { return atual < comandos.size(); }
+    // Descrição do comando que desfazer()/refazer() executariam.
+    QString proximoDesfazer() const;
+    QString proximoRefazer() const;
+
+    void setLimiteBytes(qint64 limite);
+    qint64 getLimiteBytes() const { return limiteBytes; }
+    qint64 getTamanhoBytes() const { return tamanhoBytes; }
+    int tamanho() const { return comandos.size(); }
+
+private:
+    // Executa 'acao' em 'comando' e acompanha a troca de handle e de tamanho.
+    template <typename Acao>
+    void executar(Comando* comando, Acao acao);
+    void remapear(const HandleObjeto& antigo, const HandleObjeto& novo);
+    void aplicarLimite();
+
+    QVector<Comando*> comandos;
+    int atual;  // comandos[0, atual) estão aplicados
+    qint64 limiteBytes;
+    qint64 tamanhoBytes;
+};
+
+#endif // HISTORICO_H
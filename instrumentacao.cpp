@@ -0,0 +1,305 @@
+#include "instrumentacao.h"
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+namespace {
+
+struct Evento {
+    const char* nome;
+    int thread;
+    qint64 inicio;
+    qint64 duracao;
+};
+
+struct Quadro {
+    int thread;
+    qint64 inicio;
+    qint64 duracao;
+    qint64 contadores[NUM_CONTADORES];
+};
+
+std::atomic<bool> ativa(false);
+std::atomic<int> proximaThread(0);
+
+// Os contadores são incrementados dentro dos laços do renderizador, em todas
+// as threads dos tiles: cada thread soma na sua fatia (uma linha de cache
+// própria) e as fatias só são somadas ao fechar o quadro.
+constexpr int NUM_FATIAS = 16;
+struct alignas(64) Fatia {
+    std::atomic<qint64> valores[NUM_CONTADORES];
+};
+Fatia fatias[NUM_FATIAS];
+
+// Protege os históricos; só é tomado com a instrumentação ligada.
+std::mutex mutex;
+QVector<Evento> eventos;
+QVector<Quadro> quadros;
+qint64 inicioQuadro = -1;
+
+const QElapsedTimer& relogio() {
+    static const QElapsedTimer r = [] {
+        QElapsedTimer t;
+        t.start();
+        return t;
+    }();
+    return r;
+}
+
+// Número pequeno e estável por thread, usado como "tid" no trace.
+int idThread() {
+    thread_local const int id = proximaThread.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void zerarContadores() {
+    for (Fatia& f : fatias) {
+        for (std::atomic<qint64>& v : f.valores) v.store(0, std::memory_order_relaxed);
+    }
+}
+
+qint64 somarContador(int c) {
+    qint64 soma = 0;
+    for (const Fatia& f : fatias) soma += f.valores[c].load(std::memory_order_relaxed);
+    return soma;
+}
+
+// Descarta a metade mais antiga quando o histórico passa do limite, para a
+// remoção não acontecer a cada inserção.
+template <typename T>
+void limitar(QVector<T>& v, int maximo) {
+    if (v.size() > maximo) v.remove(0, v.size() - maximo / 2);
+}
+
+double emMs(qint64 ns) {
+    return ns / 1e6;
+}
+
+void anexar(std::string& saida, const char* formato, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, formato);
+    int n = std::vsnprintf(buffer, sizeof(buffer), formato, args);
+    va_end(args);
+    if (n > 0) saida.append(buffer, std::min<size_t>(n, sizeof(buffer) - 1));
+}
+
+bool gravar(const QString& caminho, const std::string& conteudo, QString* erro) {
+    QSaveFile arquivo(caminho);
+    if (!arquivo.open(QIODevice::WriteOnly)) {
+        if (erro) *erro = "Não foi possível criar o arquivo: " + arquivo.errorString();
+        return false;
+    }
+    qint64 tamanho = static_cast<qint64>(conteudo.size());
+    if (arquivo.write(conteudo.data(), tamanho) != tamanho || !arquivo.commit()) {
+        if (erro) *erro = "Erro ao gravar o arquivo: " + arquivo.errorString();
+        return false;
+    }
+    return true;
+}
+
+// Cópia dos históricos para exportar sem segurar o mutex durante a escrita.
+void copiar(QVector<Evento>& e, QVector<Quadro>& q) {
+    std::lock_guard<std::mutex> trava(mutex);
+    e = eventos;
+    q = quadros;
+}
+
+// Nomes distintos de etapa, na ordem em que aparecem.
+QVector<const char*> nomesEtapas(const QVector<Evento>& e) {
+    QVector<const char*> nomes;
+    for (const Evento& ev : e) {
+        bool novo = std::none_of(nomes.begin(), nomes.end(),
+                                 [&ev](const char* n) { return std::strcmp(n, ev.nome) == 0; });
+        if (novo) nomes.append(ev.nome);
+    }
+    return nomes;
+}
+
+}
+
+bool Instrumentacao::isAtiva() {
+    return ativa.load(std::memory_order_relaxed);
+}
+
+void Instrumentacao::setAtiva(bool valor) {
+    std::lock_guard<std::mutex> trava(mutex);
+    if (valor && !ativa.load(std::memory_order_relaxed)) {
+        eventos.clear();
+        quadros.clear();
+        inicioQuadro = -1;
+        zerarContadores();
+    }
+    ativa.store(valor, std::memory_order_relaxed);
+}
+
+qint64 Instrumentacao::agora() {
+    return relogio().nsecsElapsed();
+}
+
+void Instrumentacao::registrarEtapa(const char* nome, qint64 inicio, qint64 duracao) {
+    Evento e = {nome, idThread(), inicio, duracao};
+    std::lock_guard<std::mutex> trava(mutex);
+    eventos.append(e);
+    limitar(eventos, MAX_EVENTOS);
+}
+
+void Instrumentacao::contar(Contador c, qint64 n) {
+    fatias[idThread() % NUM_FATIAS].valores[static_cast<int>(c)].fetch_add(n, std::memory_order_relaxed);
+}
+
+void Instrumentacao::contarResultados(Contador aceitos, Contador rejeitados,
+                                      const unsigned char* resultados, int n) {
+    qint64 a = std::count_if(resultados, resultados + n, [](unsigned char r) { return r != 0; });
+    contar(aceitos, a);
+    contar(rejeitados, n - a);
+}
+
+void Instrumentacao::iniciarQuadro() {
+    if (!isAtiva()) return;
+    zerarContadores();
+    std::lock_guard<std::mutex> trava(mutex);
+    inicioQuadro = agora();
+}
+
+void Instrumentacao::terminarQuadro() {
+    if (!isAtiva()) return;
+    qint64 fim = agora();
+    std::lock_guard<std::mutex> trava(mutex);
+    if (inicioQuadro < 0) return;
+
+    Quadro q;
+    q.thread = idThread();
+    q.inicio = inicioQuadro;
+    q.duracao = fim - inicioQuadro;
+    for (int i = 0; i < NUM_CONTADORES; ++i) {
+        q.contadores[i] = somarContador(i);
+    }
+    quadros.append(q);
+    limitar(quadros, MAX_QUADROS);
+    inicioQuadro = -1;
+}
+
+ResumoInstrumentacao Instrumentacao::resumir() {
+    ResumoInstrumentacao r = {};
+    QVector<qint64> duracoes;
+    {
+        std::lock_guard<std::mutex> trava(mutex);
+        if (quadros.isEmpty()) return r;
+        const Quadro& ultimo = quadros.last();
+        r.ultimoMs = emMs(ultimo.duracao);
+        std::copy(ultimo.contadores, ultimo.contadores + NUM_CONTADORES, r.contadores);
+        for (int i = std::max<int>(0, quadros.size() - JANELA_PERCENTIS); i < quadros.size(); ++i) {
+            duracoes.append(quadros[i].duracao);
+        }
+    }
+
+    std::sort(duracoes.begin(), duracoes.end());
+    auto percentil = [&duracoes](double p) {
+        int i = static_cast<int>(std::ceil(p * duracoes.size())) - 1;
+        return emMs(duracoes[std::clamp(i, 0, static_cast<int>(duracoes.size()) - 1)]);
+    };
+    r.quadros = static_cast<int>(duracoes.size());
+    r.p50Ms = percentil(0.50);
+    r.p95Ms = percentil(0.95);
+    r.p99Ms = percentil(0.99);
+    return r;
+}
+
+const char* Instrumentacao::nomeContador(Contador c) {
+    switch (c) {
+    case Contador::OBJETOS_CANDIDATOS: return "objetos_candidatos";
+    case Contador::OBJETOS_DESCARTADOS: return "objetos_descartados";
+    case Contador::RETAS_ACEITAS: return "retas_aceitas";
+    case Contador::RETAS_REJEITADAS: return "retas_rejeitadas";
+    case Contador::PONTOS_ACEITOS: return "pontos_aceitos";
+    case Contador::PONTOS_REJEITADOS: return "pontos_rejeitados";
+    case Contador::POLIGONOS_RECORTADOS: return "poligonos_recortados";
+    case Contador::VERTICES_TRANSFORMADOS: return "vertices_transformados";
+    default: return "desconhecido";
+    }
+}
+
+bool Instrumentacao::exportarCSV(const QString& caminho, QString* erro) {
+    QVector<Evento> e;
+    QVector<Quadro> q;
+    copiar(e, q);
+    QVector<const char*> nomes = nomesEtapas(e);
+
+    std::string saida = "quadro,inicio_ms,duracao_ms";
+    for (const char* nome : nomes) anexar(saida, ",%s_ms", nome);
+    for (int c = 0; c < NUM_CONTADORES; ++c) anexar(saida, ",%s", nomeContador(static_cast<Contador>(c)));
+    saida += '\n';
+
+    // Cada evento conta para o quadro em que começou.
+    std::sort(e.begin(), e.end(), [](const Evento& a, const Evento& b) { return a.inicio < b.inicio; });
+    QVector<qint64> somas(nomes.size());
+    int k = 0;
+    for (int i = 0; i < q.size(); ++i) {
+        const Quadro& quadro = q[i];
+        std::fill(somas.begin(), somas.end(), 0);
+        while (k < e.size() && e[k].inicio < quadro.inicio) ++k;
+        for (; k < e.size() && e[k].inicio <= quadro.inicio + quadro.duracao; ++k) {
+            for (int j = 0; j < nomes.size(); ++j) {
+                if (std::strcmp(nomes[j], e[k].nome) == 0) {
+                    somas[j] += e[k].duracao;
+                    break;
+                }
+            }
+        }
+
+        anexar(saida, "%d,%.6f,%.6f", i, emMs(quadro.inicio), emMs(quadro.duracao));
+        for (qint64 s : somas) anexar(saida, ",%.6f", emMs(s));
+        for (qint64 c : quadro.contadores) anexar(saida, ",%lld", static_cast<long long>(c));
+        saida += '\n';
+    }
+    return gravar(caminho, saida, erro);
+}
+
+bool Instrumentacao::exportarChromeTrace(const QString& caminho, QString* erro) {
+    QVector<Evento> e;
+    QVector<Quadro> q;
+    copiar(e, q);
+
+    // Tempos em microssegundos, como o formato pede.
+    std::string saida = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool primeiro = true;
+    auto separar = [&saida, &primeiro]() {
+        if (!primeiro) saida += ",\n";
+        primeiro = false;
+    };
+
+    if (!q.isEmpty()) {
+        separar();
+        anexar(saida, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"interface\"}}",
+               q.first().thread);
+    }
+    for (const Quadro& quadro : q) {
+        separar();
+        anexar(saida, "{\"name\":\"quadro\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+               quadro.thread, quadro.inicio / 1e3, quadro.duracao / 1e3);
+        separar();
+        anexar(saida, "{\"name\":\"contadores\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{",
+               (quadro.inicio + quadro.duracao) / 1e3);
+        for (int c = 0; c < NUM_CONTADORES; ++c) {
+            anexar(saida, "%s\"%s\":%lld", c ? "," : "", nomeContador(static_cast<Contador>(c)),
+                   static_cast<long long>(quadro.contadores[c]));
+        }
+        saida += "}}";
+    }
+    for (const Evento& ev : e) {
+        separar();
+        anexar(saida, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+               ev.nome, ev.thread, ev.inicio / 1e3, ev.duracao / 1e3);
+    }
+    saida += "\n]}\n";
+    return gravar(caminho, saida, erro);
+}
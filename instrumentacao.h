@@ -0,0 +1,115 @@
+#ifndef INSTRUMENTACAO_H
+#define INSTRUMENTACAO_H
+
+#include <QString>
+#include <QtGlobal>
+
+// Instrumentação dos caminhos quentes: temporizadores por escopo, contadores
+// e quadros. Só existe quando o projeto é gerado com "CONFIG += instrumentacao"
+// (que define PROJETOCG_INSTRUMENTACAO); sem isso as macros abaixo não geram
+// código nenhum. Compilada, ainda fica desligada até setAtiva(true), e desligada
+// custa uma leitura atômica por escopo medido.
+//
+// Os eventos e contadores podem vir de qualquer thread (os tiles do renderizador
+// paralelo medem suas próprias etapas); quadros são abertos e fechados na
+// thread da interface.
+
+enum class Contador {
+    OBJETOS_CANDIDATOS,    // devolvidos pela grade para um quadro/tile
+    OBJETOS_DESCARTADOS,   // caixa inteira fora da window
+    RETAS_ACEITAS,         // pelo recorte de retas
+    RETAS_REJEITADAS,
+    PONTOS_ACEITOS,
+    PONTOS_REJEITADOS,
+    POLIGONOS_RECORTADOS,
+    VERTICES_TRANSFORMADOS,
+    NUM_CONTADORES
+};
+
+constexpr int NUM_CONTADORES = static_cast<int>(Contador::NUM_CONTADORES);
+
+struct ResumoInstrumentacao {
+    int quadros;        // quadros considerados nos percentis
+    double ultimoMs;
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+    qint64 contadores[NUM_CONTADORES];  // do último quadro
+};
+
+class Instrumentacao {
+public:
+    // Quadros usados para os percentis do resumo.
+    static constexpr int JANELA_PERCENTIS = 120;
+    // Histórico mantido para exportação; os mais antigos são descartados.
+    static constexpr int MAX_QUADROS = 1000;
+    static constexpr int MAX_EVENTOS = 200000;
+
+    static bool isAtiva();
+    // Ligar descarta o histórico anterior.
+    static void setAtiva(bool ativa);
+
+    // Nanossegundos desde o início do programa, no mesmo relógio de todas as threads.
+    static qint64 agora();
+
+    static void registrarEtapa(const char* nome, qint64 inicio, qint64 duracao);
+    static void contar(Contador c, qint64 n);
+    // Soma em 'aceitos' os bytes não nulos de resultados[0..n) e o resto em 'rejeitados'.
+    static void contarResultados(Contador aceitos, Contador rejeitados, const unsigned char* resultados, int n);
+
+    // Um quadro vai de iniciarQuadro a terminarQuadro; os contadores são zerados
+    // no início e fotografados no fim.
+    static void iniciarQuadro();
+    static void terminarQuadro();
+
+    static ResumoInstrumentacao resumir();
+    static const char* nomeContador(Contador c);
+
+    // Uma linha por quadro: duração, tempo somado de cada etapa (de todas as
+    // threads) e contadores.
+    static bool exportarCSV(const QString& caminho, QString* erro = nullptr);
+    // Formato "Trace Event" do Chrome (chrome://tracing, Perfetto): uma faixa
+    // por thread e os contadores como séries.
+    static bool exportarChromeTrace(const QString& caminho, QString* erro = nullptr);
+};
+
+// Mede o escopo onde é declarada. O nome deve ser um literal.
+class EtapaInstrumentada {
+public:
+    explicit EtapaInstrumentada(const char* nome)
+        : nome(nome), inicio(Instrumentacao::isAtiva() ? Instrumentacao::agora() : -1) {}
+    ~EtapaInstrumentada() {
+        if (inicio >= 0) Instrumentacao::registrarEtapa(nome, inicio, Instrumentacao::agora() - inicio);
+    }
+
+    EtapaInstrumentada(const EtapaInstrumentada&) = delete;
+    EtapaInstrumentada& operator=(const EtapaInstrumentada&) = delete;
+
+private:
+    const char* nome;
+    qint64 inicio;
+};
+
+#ifdef PROJETOCG_INSTRUMENTACAO
+#define INSTRUMENTACAO_CONCATENAR_(a, b) a##b
+#define INSTRUMENTACAO_CONCATENAR(a, b) INSTRUMENTACAO_CONCATENAR_(a, b)
+#define MEDIR_ETAPA(nome) EtapaInstrumentada INSTRUMENTACAO_CONCATENAR(etapa_, __LINE__)(nome)
+// Os argumentos só são avaliados com a instrumentação ligada.
+#define CONTAR(contador, n) \
+    do { if (Instrumentacao::isAtiva()) Instrumentacao::contar(Contador::contador, (n)); } while (0)
+#define CONTAR_RESULTADOS(aceitos, rejeitados, resultados, n) \
+    do { \
+        if (Instrumentacao::isAtiva()) \
+            Instrumentacao::contarResultados(Contador::aceitos, Contador::rejeitados, (resultados), (n)); \
+    } while (0)
+#define INICIAR_QUADRO() Instrumentacao::iniciarQuadro()
+#define TERMINAR_QUADRO() Instrumentacao::terminarQuadro()
+#else
+#define MEDIR_ETAPA(nome) ((void)0)
+#define CONTAR(contador, n) ((void)0)
+#define CONTAR_RESULTADOS(aceitos, rejeitados, resultados, n) ((void)0)
+#define INICIAR_QUADRO() ((void)0)
+#define TERMINAR_QUADRO() ((void)0)
+#endif
+
+#endif // INSTRUMENTACAO_H
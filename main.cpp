@@ -1,9 +1,131 @@
 #include "mainwindow.h"
+#include "renderizacaolote.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QGuiApplication>
+#include <QThread>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// "a,b,c,d" -> quatro números; devolve false se faltar algum ou sobrar.
+bool lerQuatro(const QString& texto, double valores[4]) {
+    const QStringList partes = texto.split(',');
+    if (partes.size() != 4) return false;
+    for (int i = 0; i < 4; ++i) {
+        bool ok;
+        valores[i] = partes[i].trimmed().toDouble(&ok);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+int falhar(const QString& mensagem) {
+    std::fprintf(stderr, "%s\n", qPrintable(mensagem));
+    return 2;
+}
+
+// Modo sem interface: "ProjetoCG --lote [opções] arquivos-ou-diretórios...".
+int executarLote(int argc, char *argv[])
+{
+    // Sem janelas: o QPainter só desenha em QImage.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication aplicacao(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renderiza desenhos (.txt) e cenas (.cgcena) em PNG, sem abrir a janela.");
+    parser.addHelpOption();
+    QCommandLineOption opcaoLote("lote", "Ativa o modo sem interface.");
+    QCommandLineOption opcaoSaida("saida", "Diretório dos PNGs (um <nome>.png por entrada).", "diretorio", ".");
+    QCommandLineOption opcaoTamanho("tamanho", "Tamanho da imagem, LARGURAxALTURA.", "tamanho", "800x600");
+    QCommandLineOption opcaoViewport("viewport", "Viewport em pixels: xmin,ymin,xmax,ymax (padrão: a imagem inteira).", "retangulo");
+    QCommandLineOption opcaoWindow("window", "Window no mundo: xmin,ymin,xmax,ymax (padrão: a da cena, ou o desenho inteiro).", "retangulo");
+    QCommandLineOption opcaoClipping("clipping", "Recorte de retas: cohen-sutherland, liang-barsky ou liang-barsky-lote.",
+                                     "algoritmo", "liang-barsky-lote");
+    QCommandLineOption opcaoFundo("fundo", "Cor de fundo (nome ou #rrggbb; \"transparent\" para nenhuma).", "cor", "black");
+    QCommandLineOption opcaoThreads("threads", "Arquivos processados ao mesmo tempo.", "n",
+                                    QString::number(QThread::idealThreadCount()));
+    parser.addOptions({opcaoLote, opcaoSaida, opcaoTamanho, opcaoViewport, opcaoWindow, opcaoClipping, opcaoFundo, opcaoThreads});
+    parser.addPositionalArgument("entradas", "Arquivos de desenho ou cena, ou diretórios com eles.", "entradas...");
+    parser.process(aplicacao);
+
+    OpcoesRenderizacaoLote opcoes;
+    opcoes.diretorioSaida = parser.value(opcaoSaida);
+    opcoes.threads = parser.value(opcaoThreads).toInt();
+
+    const QStringList tamanho = parser.value(opcaoTamanho).split('x');
+    int largura = tamanho.size() == 2 ? tamanho[0].toInt() : 0;
+    int altura = tamanho.size() == 2 ? tamanho[1].toInt() : 0;
+    if (largura <= 0 || altura <= 0) return falhar("Tamanho inválido: " + parser.value(opcaoTamanho));
+    opcoes.tamanho = QSize(largura, altura);
+
+    double v[4];
+    if (parser.isSet(opcaoViewport)) {
+        if (!lerQuatro(parser.value(opcaoViewport), v) || v[2] <= v[0] || v[3] <= v[1]) {
+            return falhar("Viewport inválida: " + parser.value(opcaoViewport));
+        }
+        opcoes.viewport = QRect(QPoint(static_cast<int>(v[0]), static_cast<int>(v[1])),
+                                QPoint(static_cast<int>(v[2]) - 1, static_cast<int>(v[3]) - 1));
+    }
+
+    opcoes.usarWindow = parser.isSet(opcaoWindow);
+    if (opcoes.usarWindow) {
+        if (!lerQuatro(parser.value(opcaoWindow), v) || v[2] <= v[0] || v[3] <= v[1]) {
+            return falhar("Window inválida: " + parser.value(opcaoWindow));
+        }
+        opcoes.window = {v[0], v[1], v[2], v[3]};
+    }
+
+    const QString clipping = parser.value(opcaoClipping);
+    if (clipping == "cohen-sutherland") {
+        opcoes.algoritmo = AlgoritmoClipping::COHEN_SUTHERLAND;
+    } else if (clipping == "liang-barsky") {
+        opcoes.algoritmo = AlgoritmoClipping::LIANG_BARSKY;
+    } else if (clipping == "liang-barsky-lote") {
+        opcoes.algoritmo = AlgoritmoClipping::LIANG_BARSKY_LOTE;
+    } else {
+        return falhar("Algoritmo de clipping desconhecido: " + clipping);
+    }
+
+    opcoes.fundo = QColor(parser.value(opcaoFundo));
+    if (!opcoes.fundo.isValid()) return falhar("Cor inválida: " + parser.value(opcaoFundo));
+
+    QStringList entradas = RenderizacaoLote::expandirEntradas(parser.positionalArguments());
+    if (entradas.isEmpty()) return falhar("Nenhum arquivo de entrada.");
+    if (!QDir().mkpath(opcoes.diretorioSaida)) return falhar("Não foi possível criar " + opcoes.diretorioSaida);
+
+    RenderizacaoLote lote(opcoes);
+    int falhas = lote.executar(entradas, [](const ResultadoRenderizacao& r) {
+        if (r.erro.isEmpty()) {
+            std::printf("%s -> %s (%d objetos, %lld ms)\n", qPrintable(r.entrada), qPrintable(r.saida),
+                        r.objetos, static_cast<long long>(r.milissegundos));
+            std::fflush(stdout);
+        } else {
+            std::fprintf(stderr, "%s: %s\n", qPrintable(r.entrada), qPrintable(r.erro));
+        }
+    });
+    std::printf("%d de %d arquivos renderizados.\n", static_cast<int>(entradas.size()) - falhas,
+                static_cast<int>(entradas.size()));
+    return falhas == 0 ? 0 : 1;
+}
+
+}
 
 int main(int argc, char *argv[])
 {
+    // O modo em lote precisa ser decidido antes de criar a aplicação, pois
+    // não usa QApplication nem abre janela.
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--lote") == 0) {
+            return executarLote(argc, argv);
+        }
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
@@ -3,19 +3,33 @@
 #include <QPainter>
 #include <QMessageBox>
 #include <QFileDialog>
-#include <QTextStream>
-#include <QRegularExpression>
+#include <QKeySequence>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Retângulo do canvas (coordenadas da janela) em pixels da imagem da cena,
+// que tem devicePixelRatio pixels por unidade lógica.
+QRectF pixelsNaCena(const QRect& retangulo, const QRect& areaCanvas, qreal escala) {
+    return QRectF((retangulo.left() - areaCanvas.left()) * escala, (retangulo.top() - areaCanvas.top()) * escala,
+                  retangulo.width() * escala, retangulo.height() * escala);
+}
+}
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , modoDesenho(ModoDesenho::NENHUM)
+    , objetoSobCursor(nullptr)
+    , cenaSuja(true)
+    , cancelarCarregamento(false)
+    , retasCarregadas(0)
+    , vagasLotes(LOTES_EM_VOO)
+    , geracaoCarregamento(0)
 {
     ui->setupUi(this);
 
-    connect(ui->listWidget_objetos, &QListWidget::itemChanged, this, &MainWindow::on_listWidget_objetos_itemChanged);
-    connect(ui->pushButton_carregarDesenho, &QPushButton::clicked, this, &MainWindow::on_pushButton_carregarDesenho_clicked);
-
     ui->canvasWidget->installEventFilter(this);
     ui->canvasWidget->setMouseTracking(true);
 
@@ -30,12 +44,19 @@ MainWindow::MainWindow(QWidget *parent)
     double w_xmax = canvas_width - padding;
     double w_ymax = canvas_height - padding;
 
-    a_window = new WindowGrafica("Window", Ponto(w_xmin, w_ymin), Ponto(w_xmax, w_ymax));
+    armazem = new ArmazemVertices();
+    objetos = new ArmazemObjetos(armazem);
+    grade = new GradeEspacial();
+
+    a_window = new WindowGrafica(armazem, "Window", Ponto(w_xmin, w_ymin), Ponto(w_xmax, w_ymax));
     a_window->setVisivel(true);
 
     displayFile.prepend(a_window);
 
+    // A window é aplicada pela sua matriz de normalização; o transformador
+    // só leva o quadrado normalizado [-1, 1] para a viewport.
     transformador = new TransformadorCoordenadas();
+    transformador->setWindow(-1.0, -1.0, 1.0, 1.0);
     transformador->setViewport(w_xmin, w_ymin, w_xmax, w_ymax);
 
     LimitesWindow limitesIniciais = a_window->getLimites();
@@ -49,35 +70,148 @@ MainWindow::MainWindow(QWidget *parent)
     ui->lineEdit_v_ymax->setText(QString::number(w_ymax));
 
     clipper = new Clipping();
-
-    atualizarListaObjetos();
+    renderizador = new Renderizador(*clipper);
+    renderizadorParalelo = new RenderizadorParalelo(*clipper);
+    seletor = new SeletorObjetos();
+    historico = new Historico();
+
+    ui->comboBox_clipping->blockSignals(true);
+    ui->comboBox_clipping->addItem(Clipping::nomeAlgoritmo(AlgoritmoClipping::COHEN_SUTHERLAND));
+    ui->comboBox_clipping->addItem(Clipping::nomeAlgoritmo(AlgoritmoClipping::LIANG_BARSKY));
+    ui->comboBox_clipping->addItem(Clipping::nomeAlgoritmo(AlgoritmoClipping::LIANG_BARSKY_LOTE));
+    ui->comboBox_clipping->setCurrentIndex(static_cast<int>(clipper->getAlgoritmo()));
+    ui->comboBox_clipping->blockSignals(false);
+
+    // Na ordem de TipoCurva.
+    ui->comboBox_tipoCurva->addItem("Bézier");
+    ui->comboBox_tipoCurva->addItem("B-spline");
+
+    barraProgresso = new QProgressBar(ui->statusbar);
+    barraProgresso->setRange(0, 100);
+    barraProgresso->setMaximumWidth(200);
+    barraProgresso->hide();
+    botaoCancelarCarregamento = new QPushButton("Cancelar", ui->statusbar);
+    botaoCancelarCarregamento->hide();
+    ui->statusbar->addPermanentWidget(barraProgresso);
+    ui->statusbar->addPermanentWidget(botaoCancelarCarregamento);
+    connect(botaoCancelarCarregamento, &QPushButton::clicked, this, [this]() {
+        cancelarCarregamento = true;
+        botaoCancelarCarregamento->setEnabled(false);
+    });
+
+    ui->pushButton_desfazer->setShortcut(QKeySequence::Undo);
+    ui->pushButton_refazer->setShortcut(QKeySequence::Redo);
+    atualizarBotoesHistorico();
+
+    rotuloDesempenho = new QLabel(ui->statusbar);
+    rotuloDesempenho->hide();
+    ui->statusbar->addPermanentWidget(rotuloDesempenho);
+#ifndef PROJETOCG_INSTRUMENTACAO
+    // Sem "CONFIG += instrumentacao" nada é medido, então não há o que mostrar.
+    ui->checkBox_desempenho->hide();
+    ui->pushButton_exportarTrace->hide();
+#endif
+
+    // Com itens de altura fixa a view não precisa medir cada linha, então o
+    // custo de exibir a lista não cresce com o número de objetos.
+    modeloObjetos = new ModeloObjetos(displayFile);
+    ui->listView_objetos->setUniformItemSizes(true);
+    ui->listView_objetos->setModel(modeloObjetos);
+    connect(modeloObjetos, &ModeloObjetos::visibilidadeAlterada, this, &MainWindow::aplicarVisibilidade);
+    connect(ui->listView_objetos->selectionModel(), &QItemSelectionModel::currentChanged, this,
+            [this](const QModelIndex& atual, const QModelIndex& anterior) {
+        for (int linha : {atual.row(), anterior.row()}) {
+            if (linha > 0 && linha < displayFile.size()) invalidarDestaque(displayFile[linha]);
+        }
+    });
 }
 
 MainWindow::~MainWindow()
 {
-    for(ObjetoGrafico* obj : displayFile) {
-        delete obj;
-    }
+    cancelarCarregamento = true;
+    carregamento.waitForFinished();
+
+    ui->listView_objetos->setModel(nullptr);
+    delete modeloObjetos;
+    // A window não vem do armazém de objetos; o resto do display file sim.
     displayFile.clear();
+    delete a_window;
+    delete objetos;
+    delete grade;
+    delete armazem;
     delete transformador;
+    delete renderizador;
+    delete renderizadorParalelo;
+    delete seletor;
+    delete historico;
     delete clipper;
     delete ui;
 }
 
-void MainWindow::atualizarListaObjetos() {
-    ui->listWidget_objetos->blockSignals(true);
+void MainWindow::adicionarObjeto(ObjetoGrafico* obj) {
+    modeloObjetos->comecarInsercao(1);
+    displayFile.append(obj);
+    modeloObjetos->terminarInsercao();
+    grade->inserir(obj);
+    invalidarObjeto(obj);
+    registrarComando(new ComandoExistencia(objetos->handle(obj)));
+}
+
+void MainWindow::invalidarCena() {
+    cenaSuja = true;
+    update();
+}
 
-    ui->listWidget_objetos->clear();
-    for (int i = 0; i < displayFile.size(); ++i) {
-        ObjetoGrafico* obj = displayFile[i];
-        QListWidgetItem* item = new QListWidgetItem();
-        QString textoItem = QString("%1 (%2)").arg(obj->getNome()).arg(tipoParaString(obj->getTipo()));
-        item->setText(textoItem);
-        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-        item->setCheckState(obj->isVisivel() ? Qt::Checked : Qt::Unchecked);
-        ui->listWidget_objetos->addItem(item);
+void MainWindow::invalidarObjeto(const ObjetoGrafico* obj) {
+    invalidarCaixa(obj->getCaixa());
+}
+
+void MainWindow::invalidarCaixa(const CaixaLimite& caixa) {
+    QRect areaCanvas = ui->canvasWidget->geometry();
+    QRect regiao = Renderizador::regiaoViewport(caixa, a_window, transformador->getTransformacao())
+                       .toAlignedRect().intersected(areaCanvas);
+    if (regiao.isEmpty()) return;
+    regiaoSuja |= regiao;
+    update(regiao);
+}
+
+void MainWindow::renderizarCena(const QRect& areaCanvas) {
+    // Em telas HiDPI a cena tem a resolução física, senão a composição a amplia e borra.
+    const qreal escala = devicePixelRatioF();
+    if (cena.size() != areaCanvas.size() * escala || cena.devicePixelRatio() != escala) {
+        cena = QImage(areaCanvas.size() * escala, QImage::Format_ARGB32_Premultiplied);
+        cena.setDevicePixelRatio(escala);
+        cenaSuja = true;
+    }
+    if (!cenaSuja && regiaoSuja.isEmpty()) return;
+
+    QRect regiao = cenaSuja ? areaCanvas : regiaoSuja.intersected(areaCanvas);
+    cenaSuja = false;
+    regiaoSuja = QRect();
+    if (regiao.isEmpty()) return;
+    MEDIR_ETAPA("renderizar_cena");
+
+    if (ui->checkBox_renderParalelo->isChecked()) {
+        renderizadorParalelo->desenharCena(cena, areaCanvas.topLeft(), regiao, *grade, a_window,
+                                           transformador->getTransformacao());
+        return;
     }
-    ui->listWidget_objetos->blockSignals(false);
+
+    // A imagem usa as mesmas coordenadas do canvas na janela. Com escala
+    // fracionária a região é alargada até pixels inteiros da imagem, para não
+    // sobrar borda meio apagada.
+    QRect pixels = pixelsNaCena(regiao, areaCanvas, escala).toAlignedRect().intersected(cena.rect());
+    QRectF regiaoLogica(areaCanvas.left() + pixels.left() / escala, areaCanvas.top() + pixels.top() / escala,
+                        pixels.width() / escala, pixels.height() / escala);
+    QPainter painterCena(&cena);
+    painterCena.translate(-areaCanvas.left(), -areaCanvas.top());
+    painterCena.setClipRect(regiaoLogica);
+    painterCena.setCompositionMode(QPainter::CompositionMode_Source);
+    painterCena.fillRect(regiaoLogica, Qt::transparent);
+    painterCena.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    QRectF regiaoConsulta = (regiao == areaCanvas) ? QRectF() : regiaoLogica;
+    renderizador->desenharCena(painterCena, *grade, a_window, transformador->getTransformacao(), regiaoConsulta);
 }
 
 void MainWindow::resetarModoDesenho() {
@@ -88,79 +222,157 @@ void MainWindow::resetarModoDesenho() {
 }
 
 void MainWindow::paintEvent(QPaintEvent *event) {
-    Q_UNUSED(event);
-    QPainter painter(this);
-    painter.setClipRect(ui->canvasWidget->geometry());
-    painter.setPen(QPen(Qt::green, 2));
+    QRect areaCanvas = ui->canvasWidget->geometry();
+    QRect alvo = event->rect().intersected(areaCanvas);
+    if (alvo.isEmpty()) {
+        // Pinturas fora do canvas (a barra de status, por exemplo) não contam como quadro.
+        renderizarCena(areaCanvas);
+        return;
+    }
 
-    LimitesWindow limites = a_window->getLimites();
-    transformador->setWindow(limites.xmin, limites.ymin, limites.xmax, limites.ymax);
-    Matrix T_wv = transformador->getTransformacao();
-
-    for (const auto& objOriginal : displayFile) {
-        if (objOriginal->isVisivel()) {
-            ObjetoGrafico* objCopia = objOriginal->clone();
-
-            PontoGrafico* ponto = dynamic_cast<PontoGrafico*>(objCopia);
-            RetaGrafica* reta = dynamic_cast<RetaGrafica*>(objCopia);
-            PoligonoGrafico* poligono = dynamic_cast<PoligonoGrafico*>(objCopia);
-
-            if (ponto) {
-                Ponto p = ponto->getPontos()[0];
-                if (clipper->clipPonto(p, limites)) {
-                    objCopia->aplicarTransformacao(T_wv);
-                    objCopia->desenhar(painter);
-                }
-            } else if (reta) {
-                Ponto p1 = reta->getPontos()[0];
-                Ponto p2 = reta->getPontos()[1];
-
-                if (clipper->clipReta(p1, p2, limites)) {
-                    reta->getPontos()[0] = p1;
-                    reta->getPontos()[1] = p2;
-                    objCopia->aplicarTransformacao(T_wv);
-                    objCopia->desenhar(painter);
-                }
-            } else if (poligono && poligono != static_cast<ObjetoGrafico*>(a_window)) {
-                QVector<Ponto>& vertices = poligono->getPontos();
-                if (vertices.size() >= 2) {
-                    for (int i = 0; i < vertices.size(); ++i) {
-                        Ponto p1 = vertices[i];
-                        Ponto p2 = vertices[(i + 1) % vertices.size()];
-
-                        if (clipper->clipReta(p1, p2, limites)) {
-                            Matrix m_p1 = p1;
-                            Matrix m_p2 = p2;
-                            Matrix p1_transformado = T_wv * m_p1;
-                            Matrix p2_transformado = T_wv * m_p2;
-                            painter.drawLine(p1_transformado.at(0,0), p1_transformado.at(1,0),
-                                             p2_transformado.at(0,0), p2_transformado.at(1,0));
-                        }
-                    }
-                }
-            } else {
-                objCopia->aplicarTransformacao(T_wv);
-                objCopia->desenhar(painter);
+    INICIAR_QUADRO();
+    renderizarCena(areaCanvas);
+    {
+        MEDIR_ETAPA("compor_canvas");
+        QPainter painter(this);
+        painter.setClipRect(alvo);
+        painter.drawImage(QRectF(alvo), cena, pixelsNaCena(alvo, areaCanvas, cena.devicePixelRatio()));
+
+        // Destaques do objeto selecionado e do objeto sob o cursor, por cima da cena.
+        int selecionado = ui->listView_objetos->currentIndex().row();
+        if (selecionado > 0 && selecionado < displayFile.size()) {
+            desenharDestaque(painter, displayFile[selecionado], Qt::cyan);
+        }
+        if (objetoSobCursor && (selecionado <= 0 || objetoSobCursor != displayFile[selecionado])) {
+            desenharDestaque(painter, objetoSobCursor, QColor(255, 140, 0));
+        }
+
+        if (!pontosTemporarios.isEmpty()) {
+            painter.setPen(QPen(Qt::yellow, 3, Qt::DashLine));
+            painter.drawPoints(pontosTemporarios.constData(), pontosTemporarios.size());
+            if (modoDesenho != ModoDesenho::PONTO && pontosTemporarios.size() > 1) {
+                painter.drawPolyline(pontosTemporarios.constData(), pontosTemporarios.size());
             }
-            delete objCopia;
         }
     }
+    TERMINAR_QUADRO();
+
+#ifdef PROJETOCG_INSTRUMENTACAO
+    atualizarPainelDesempenho();
+#endif
+}
 
-    if (!pontosTemporarios.isEmpty()) {
-        painter.setPen(QPen(Qt::yellow, 3, Qt::DashLine));
-        for(const QPoint& p : pontosTemporarios) {
-            painter.drawPoint(p);
+void MainWindow::atualizarPainelDesempenho() {
+    if (!Instrumentacao::isAtiva()) return;
+
+    ResumoInstrumentacao r = Instrumentacao::resumir();
+    auto contador = [&r](Contador c) { return r.contadores[static_cast<int>(c)]; };
+    rotuloDesempenho->setText(
+        QString("Quadro %1 ms | p50 %2 | p95 %3 | p99 %4 (%5 quadros) | %6 objetos, retas %7/%8, %9 vértices")
+            .arg(r.ultimoMs, 0, 'f', 2)
+            .arg(r.p50Ms, 0, 'f', 2)
+            .arg(r.p95Ms, 0, 'f', 2)
+            .arg(r.p99Ms, 0, 'f', 2)
+            .arg(r.quadros)
+            .arg(contador(Contador::OBJETOS_CANDIDATOS))
+            .arg(contador(Contador::RETAS_ACEITAS))
+            .arg(contador(Contador::RETAS_ACEITAS) + contador(Contador::RETAS_REJEITADAS))
+            .arg(contador(Contador::VERTICES_TRANSFORMADOS)));
+}
+
+void MainWindow::desenharDestaque(QPainter& painter, const ObjetoGrafico* obj, const QColor& cor) const {
+    Mat3 T_vp = transformador->getTransformacao();
+    Mat3 T_total = T_vp * a_window->getMatrizNormalizacao();
+    Ponto a = T_vp * Ponto(-1.0, -1.0);
+    Ponto b = T_vp * Ponto(1.0, 1.0);
+
+    QPolygonF pontos;
+    if (obj->getTipo() == TipoObjeto::CURVA) {
+        // A curva em si, com a polilinha que o Renderizador já deixou no cache.
+        const CurvaGrafica* curva = static_cast<const CurvaGrafica*>(obj);
+        QVector<double> xs, ys;
+        curva->tesselacaoAtual(curva->toleranciaPadrao(), xs, ys);
+        Mat3 M = obj->temModelo() ? T_total * obj->getModelo() : T_total;
+        pontos.reserve(xs.size());
+        for (int i = 0; i < xs.size(); ++i) {
+            Ponto p = M * Ponto(xs[i], ys[i]);
+            pontos.append(QPointF(p.getX(), p.getY()));
         }
-        if ((modoDesenho == ModoDesenho::POLIGONO || modoDesenho == ModoDesenho::RETA) && pontosTemporarios.size() > 1) {
-            for (int i = 0; i < pontosTemporarios.size() - 1; ++i) {
-                painter.drawLine(pontosTemporarios[i], pontosTemporarios[i+1]);
-            }
+    } else {
+        pontos.reserve(obj->getNumPontos());
+        for (int i = 0; i < obj->getNumPontos(); ++i) {
+            Ponto p = T_total * obj->getPonto(i);
+            pontos.append(QPointF(p.getX(), p.getY()));
         }
     }
+
+    // Recortado à viewport, como a cena.
+    painter.save();
+    painter.setClipRect(QRectF(QPointF(a.getX(), a.getY()), QPointF(b.getX(), b.getY())).normalized(), Qt::IntersectClip);
+    painter.setBrush(Qt::NoBrush);
+    switch (obj->getTipo()) {
+    case TipoObjeto::PONTO:
+        painter.setPen(QPen(cor, 8, Qt::SolidLine, Qt::RoundCap));
+        painter.drawPoints(pontos);
+        break;
+    case TipoObjeto::RETA:
+    case TipoObjeto::CURVA:
+        painter.setPen(QPen(cor, 3));
+        painter.drawPolyline(pontos);
+        break;
+    case TipoObjeto::POLIGONO:
+        painter.setPen(QPen(cor, 3));
+        painter.drawPolygon(pontos);
+        break;
+    }
+    painter.restore();
+}
+
+ObjetoGrafico* MainWindow::objetoEm(const QPoint& posCanvas) {
+    // O canvas é desenhado a partir de geometry().topLeft() (ver paintEvent).
+    QPoint p = posCanvas + ui->canvasWidget->geometry().topLeft();
+    Mat3 T_vp = transformador->getTransformacao();
+    Mat3 T_total = T_vp * a_window->getMatrizNormalizacao();
+    // Viewport ou window degenerada: nada pode ser apontado.
+    Mat3 vpInversa, totalInversa;
+    if (!T_vp.inversa(vpInversa) || !T_total.inversa(totalInversa)) return nullptr;
+
+    Ponto normalizado = vpInversa * Ponto(p.x(), p.y());
+    if (std::abs(normalizado.getX()) > 1.0 || std::abs(normalizado.getY()) > 1.0) return nullptr;
+
+    double escala = std::sqrt(std::abs(T_total.at(0, 0) * T_total.at(1, 1) - T_total.at(0, 1) * T_total.at(1, 0)));
+    if (escala <= 0.0) return nullptr;
+    Ponto mundo = totalInversa * Ponto(p.x(), p.y());
+
+    // Mesma regra do Renderizador: com células menores que um pixel os objetos
+    // pequenos aparecem só como pontos agregados e não são selecionáveis um a um.
+    bool incluirPequenos = grade->getTamanhoCelula() * escala >= 1.0;
+    return seletor->selecionar(*grade, mundo.getX(), mundo.getY(), TOLERANCIA_SELECAO / escala, incluirPequenos);
+}
+
+void MainWindow::destacar(ObjetoGrafico* obj) {
+    if (obj == objetoSobCursor) return;
+    if (objetoSobCursor) invalidarDestaque(objetoSobCursor);
+    objetoSobCursor = obj;
+    if (obj) invalidarDestaque(obj);
+}
+
+void MainWindow::invalidarDestaque(const ObjetoGrafico* obj) {
+    // O destaque é desenhado por cima da cena, então só é preciso repintar, não renderizar.
+    update(Renderizador::regiaoViewport(obj->getCaixa(), a_window, transformador->getTransformacao()).toAlignedRect());
 }
 
 bool MainWindow::eventFilter(QObject *obj, QEvent *event)
 {
+    if (obj == ui->canvasWidget && event->type() == QEvent::MouseMove) {
+        QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
+        destacar(modoDesenho == ModoDesenho::NENHUM ? objetoEm(mouseEvent->pos()) : nullptr);
+        return false;
+    }
+    if (obj == ui->canvasWidget && event->type() == QEvent::Leave) {
+        destacar(nullptr);
+        return false;
+    }
     if (obj == ui->canvasWidget && event->type() == QEvent::MouseButtonPress) {
         QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
 
@@ -170,10 +382,8 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
                 nome = QString("Ponto %1").arg(displayFile.size() + 1);
             }
             Ponto p(mouseEvent->pos().x(), mouseEvent->pos().y());
-            displayFile.append(new PontoGrafico(nome, p));
-            atualizarListaObjetos();
+            adicionarObjeto(objetos->criarPonto(nome, p));
             resetarModoDesenho();
-            update();
             return true;
         }
         else if (modoDesenho == ModoDesenho::RETA) {
@@ -185,24 +395,34 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
                 }
                 Ponto p1(pontosTemporarios[0].x(), pontosTemporarios[0].y());
                 Ponto p2(pontosTemporarios[1].x(), pontosTemporarios[1].y());
-                displayFile.append(new RetaGrafica(nome, p1, p2));
-                atualizarListaObjetos();
+                adicionarObjeto(objetos->criarReta(nome, p1, p2));
                 resetarModoDesenho();
             }
             update();
             return true;
         }
-        else if (modoDesenho == ModoDesenho::POLIGONO) {
+        else if (modoDesenho == ModoDesenho::POLIGONO || modoDesenho == ModoDesenho::CURVA) {
             pontosTemporarios.append(mouseEvent->pos());
             update();
             return true;
         }
+        else {
+            ObjetoGrafico* alvo = objetoEm(mouseEvent->pos());
+            int linha = alvo ? displayFile.indexOf(alvo) : -1;
+            QModelIndex indice = linha >= 0 ? modeloObjetos->index(linha) : QModelIndex();
+            ui->listView_objetos->setCurrentIndex(indice);
+            if (indice.isValid()) {
+                ui->listView_objetos->scrollTo(indice);
+            }
+            return true;
+        }
     }
     return QMainWindow::eventFilter(obj, event);
 }
 
 void MainWindow::on_pushButton_transladar_clicked() {
-    int index = ui->listWidget_objetos->currentRow();
+    MEDIR_ETAPA("transladar");
+    int index = ui->listView_objetos->currentIndex().row();
     if (index < 0) {
         QMessageBox::warning(this, "Aviso", "Selecione um objeto para transladar.");
         return;
@@ -212,52 +432,47 @@ void MainWindow::on_pushButton_transladar_clicked() {
     double dy = ui->lineEdit_dy->text().toDouble();
 
     if (index == 0) {
-        Matrix matrizT_inversa = Matrix::criarMatrizTranslacao(-dx, -dy);
-        for (int i = 1; i < displayFile.size(); ++i) {
-            displayFile[i]->aplicarTransformacao(matrizT_inversa);
-        }
+        EstadoWindow antes = estadoWindow();
+        a_window->transladar(dx, dy);
+        registrarComando(new ComandoWindow(antes, estadoWindow()));
+        invalidarCena();
     } else {
-        Matrix matrizT = Matrix::criarMatrizTranslacao(dx, dy);
-        displayFile[index]->aplicarTransformacao(matrizT);
+        transformarSelecionado(index, Mat3::criarMatrizTranslacao(dx, dy), "Transladar");
     }
-    update();
 }
 
 void MainWindow::on_pushButton_escalar_clicked() {
-    int index = ui->listWidget_objetos->currentRow();
+    MEDIR_ETAPA("escalar");
+    int index = ui->listView_objetos->currentIndex().row();
     if (index < 0) return;
 
     double sx = ui->lineEdit_sx->text().toDouble();
     double sy = ui->lineEdit_sy->text().toDouble();
 
+    // Escala zero não tem inversa: não daria para desfazer.
+    if (sx == 0 || sy == 0) {
+        QMessageBox::warning(this, "Aviso", "Fator de escala não pode ser zero.");
+        return;
+    }
+
     if (index == 0) {
-        if (sx == 0 || sy == 0) {
-            QMessageBox::warning(this, "Aviso", "Fator de escala não pode ser zero.");
-            return;
-        }
-        Ponto centro = a_window->calcularCentro();
-        Matrix T1 = Matrix::criarMatrizTranslacao(-centro.getX(), -centro.getY());
-        Matrix S_inversa = Matrix::criarMatrizEscala(1.0/sx, 1.0/sy);
-        Matrix T2 = Matrix::criarMatrizTranslacao(centro.getX(), centro.getY());
-        Matrix matrizFinal_inversa = T2 * S_inversa * T1;
-
-        for (int i = 1; i < displayFile.size(); ++i) {
-            displayFile[i]->aplicarTransformacao(matrizFinal_inversa);
-        }
+        EstadoWindow antes = estadoWindow();
+        a_window->escalar(sx, sy);
+        registrarComando(new ComandoWindow(antes, estadoWindow()));
+        invalidarCena();
     } else {
         Ponto centro = displayFile[index]->calcularCentro();
-        Matrix T1 = Matrix::criarMatrizTranslacao(-centro.getX(), -centro.getY());
-        Matrix S = Matrix::criarMatrizEscala(sx, sy);
-        Matrix T2 = Matrix::criarMatrizTranslacao(centro.getX(), centro.getY());
-        Matrix matrizFinal = T2 * S * T1;
-        displayFile[index]->aplicarTransformacao(matrizFinal);
+        Mat3 T1 = Mat3::criarMatrizTranslacao(-centro.getX(), -centro.getY());
+        Mat3 S = Mat3::criarMatrizEscala(sx, sy);
+        Mat3 T2 = Mat3::criarMatrizTranslacao(centro.getX(), centro.getY());
+        transformarSelecionado(index, T2 * S * T1, "Escalar");
     }
-    update();
 }
 
 void MainWindow::on_pushButton_rotacionar_clicked()
 {
-    int index = ui->listWidget_objetos->currentRow();
+    MEDIR_ETAPA("rotacionar");
+    int index = ui->listView_objetos->currentIndex().row();
     if (index < 0) {
         QMessageBox::warning(this, "Aviso", "Selecione um objeto para rotacionar.");
         return;
@@ -265,15 +480,10 @@ void MainWindow::on_pushButton_rotacionar_clicked()
     double angulo = ui->lineEdit_angulo->text().toDouble();
 
     if (index == 0) {
-        Ponto pivo = a_window->calcularCentro();
-        Matrix T1 = Matrix::criarMatrizTranslacao(-pivo.getX(), -pivo.getY());
-        Matrix R_inversa = Matrix::criarMatrizRotacao(-angulo);
-        Matrix T2 = Matrix::criarMatrizTranslacao(pivo.getX(), pivo.getY());
-        Matrix matrizFinal_inversa = T2 * R_inversa * T1;
-
-        for (int i = 1; i < displayFile.size(); ++i) {
-            displayFile[i]->aplicarTransformacao(matrizFinal_inversa);
-        }
+        EstadoWindow antes = estadoWindow();
+        a_window->rotacionar(angulo);
+        registrarComando(new ComandoWindow(antes, estadoWindow()));
+        invalidarCena();
     } else {
         Ponto pivo;
         if (ui->checkBox_usarPontoEspecifico->isChecked()) {
@@ -288,13 +498,11 @@ void MainWindow::on_pushButton_rotacionar_clicked()
         } else {
             pivo = displayFile[index]->calcularCentro();
         }
-        Matrix T1 = Matrix::criarMatrizTranslacao(-pivo.getX(), -pivo.getY());
-        Matrix R = Matrix::criarMatrizRotacao(angulo);
-        Matrix T2 = Matrix::criarMatrizTranslacao(pivo.getX(), pivo.getY());
-        Matrix matrizFinal = T2 * R * T1;
-        displayFile[index]->aplicarTransformacao(matrizFinal);
+        Mat3 T1 = Mat3::criarMatrizTranslacao(-pivo.getX(), -pivo.getY());
+        Mat3 R = Mat3::criarMatrizRotacao(angulo);
+        Mat3 T2 = Mat3::criarMatrizTranslacao(pivo.getX(), pivo.getY());
+        transformarSelecionado(index, T2 * R * T1, "Rotacionar");
     }
-    update();
 }
 
 void MainWindow::on_pushButton_addPonto_clicked()
@@ -318,8 +526,41 @@ void MainWindow::on_pushButton_addPoligono_clicked()
     ui->statusbar->showMessage("Modo 'Desenhar Polígono' ativado. Clique nos vértices e depois em 'Finalizar'.");
 }
 
+void MainWindow::on_pushButton_addCurva_clicked()
+{
+    modoDesenho = ModoDesenho::CURVA;
+    pontosTemporarios.clear();
+    if (static_cast<TipoCurva>(ui->comboBox_tipoCurva->currentIndex()) == TipoCurva::BEZIER) {
+        ui->statusbar->showMessage("Modo 'Desenhar Curva' ativado. Clique em 4, 7, 10... pontos de controle e depois em 'Finalizar'.");
+    } else {
+        ui->statusbar->showMessage("Modo 'Desenhar Curva' ativado. Clique em 4 ou mais pontos de controle e depois em 'Finalizar'.");
+    }
+}
+
 void MainWindow::on_pushButton_finalizarDesenho_clicked()
 {
+    if (modoDesenho == ModoDesenho::CURVA) {
+        TipoCurva tipoCurva = static_cast<TipoCurva>(ui->comboBox_tipoCurva->currentIndex());
+        if (!CurvaGrafica::quantidadeValida(tipoCurva, pontosTemporarios.size())) {
+            QMessageBox::warning(this, "Aviso", tipoCurva == TipoCurva::BEZIER
+                ? "Uma curva de Bézier precisa de 4, 7, 10... pontos de controle (3 por segmento, mais 1)."
+                : "Uma B-spline precisa de pelo menos 4 pontos de controle.");
+            resetarModoDesenho();
+            return;
+        }
+        QString nome = ui->lineEdit_nomeObjeto->text();
+        if (nome.isEmpty()) {
+            nome = QString("Curva %1").arg(displayFile.size() + 1);
+        }
+        QVector<Ponto> controle;
+        for (const QPoint& qp : pontosTemporarios) {
+            controle.append(Ponto(qp.x(), qp.y()));
+        }
+        adicionarObjeto(objetos->criarCurva(nome, tipoCurva, controle));
+        resetarModoDesenho();
+        return;
+    }
+
     if (modoDesenho == ModoDesenho::POLIGONO && pontosTemporarios.size() >= 3) {
         QString nome = ui->lineEdit_nomeObjeto->text();
         if (nome.isEmpty()) {
@@ -329,8 +570,7 @@ void MainWindow::on_pushButton_finalizarDesenho_clicked()
         for(const QPoint& qp : pontosTemporarios) {
             vertices.append(Ponto(qp.x(), qp.y()));
         }
-        displayFile.append(new PoligonoGrafico(nome, vertices));
-        atualizarListaObjetos();
+        adicionarObjeto(objetos->criarPoligono(nome, vertices, ui->checkBox_preencher->isChecked()));
         resetarModoDesenho();
     } else {
         QMessageBox::warning(this, "Aviso", "Para finalizar um polígono, você precisa de pelo menos 3 pontos.");
@@ -350,7 +590,7 @@ void MainWindow::on_checkBox_usarPontoEspecifico_toggled(bool checked)
 
 void MainWindow::on_pushButton_excluir_clicked()
 {
-    int index = ui->listWidget_objetos->currentRow();
+    int index = ui->listView_objetos->currentIndex().row();
 
     if (index < 0) {
         QMessageBox::warning(this, "Aviso", "Selecione um objeto para excluir.");
@@ -361,22 +601,23 @@ void MainWindow::on_pushButton_excluir_clicked()
         return;
     }
 
-    delete displayFile[index];
-    displayFile.removeAt(index);
-    atualizarListaObjetos();
-    update();
+    // Só a cópia do objeto vai para o histórico; o resto da cena não é tocado.
+    HandleObjeto handle = objetos->handle(displayFile[index]);
+    CopiaObjeto copia = removerObjeto(displayFile[index]);
+    registrarComando(new ComandoExistencia(handle, copia));
 }
 
-void MainWindow::on_listWidget_objetos_itemChanged(QListWidgetItem *item)
+void MainWindow::aplicarVisibilidade(int linha)
 {
-    int index = ui->listWidget_objetos->row(item);
-    if (index < 0 || index >= displayFile.size()) return;
-
-    ObjetoGrafico* obj = displayFile[index];
-    bool isChecked = (item->checkState() == Qt::Checked);
-    obj->setVisivel(isChecked);
-
-    update();
+    ObjetoGrafico* obj = displayFile[linha];
+    if (obj == a_window) {
+        invalidarCena();
+    } else {
+        // A pirâmide de ocupação da grade só conta objetos visíveis.
+        grade->atualizar(obj);
+        invalidarObjeto(obj);
+        registrarComando(new ComandoVisibilidade(objetos->handle(obj), obj->isVisivel()));
+    }
 }
 
 void MainWindow::on_pushButton_aplicar_wv_clicked()
@@ -386,63 +627,425 @@ void MainWindow::on_pushButton_aplicar_wv_clicked()
     double w_xmax = ui->lineEdit_w_xmax->text().toDouble();
     double w_ymax = ui->lineEdit_w_ymax->text().toDouble();
 
-    a_window->atualizarLimites(w_xmin, w_ymin, w_xmax, w_ymax);
-
     int v_xmin = ui->lineEdit_v_xmin->text().toInt();
     int v_ymin = ui->lineEdit_v_ymin->text().toInt();
     int v_xmax = ui->lineEdit_v_xmax->text().toInt();
     int v_ymax = ui->lineEdit_v_ymax->text().toInt();
 
+    // Largura ou altura zero deixariam as matrizes de normalização e de viewport sem inversa.
+    if (!(w_xmax > w_xmin) || !(w_ymax > w_ymin) || !std::isfinite(w_xmax - w_xmin) || !std::isfinite(w_ymax - w_ymin)) {
+        QMessageBox::warning(this, "Erro de Entrada", "A window precisa de xmin < xmax e ymin < ymax.");
+        return;
+    }
+    if (v_xmax == v_xmin || v_ymax == v_ymin) {
+        QMessageBox::warning(this, "Erro de Entrada", "A viewport precisa ter largura e altura diferentes de zero.");
+        return;
+    }
+
+    // Window e viewport num só comando, para desfazer as duas juntas.
+    EstadoWindow antes = estadoWindow();
+    a_window->atualizarLimites(w_xmin, w_ymin, w_xmax, w_ymax);
     transformador->setViewport(v_xmin, v_ymin, v_xmax, v_ymax);
+    registrarComando(new ComandoWindow(antes, estadoWindow()));
 
-    update();
+    invalidarCena();
 }
 
 void MainWindow::on_pushButton_carregarDesenho_clicked()
 {
-    QString filePath = QFileDialog::getOpenFileName(this, "Abrir Desenho", "", "Arquivos de Texto (*.txt)");
+    QString filePath = QFileDialog::getOpenFileName(this, "Abrir Desenho", "",
+                                                    "Desenhos (*.txt *.cgcena);;Arquivos de Texto (*.txt);;Cenas (*.cgcena)");
 
     if (filePath.isEmpty()) {
         return;
     }
+    if (filePath.endsWith(".cgcena", Qt::CaseInsensitive)) {
+        carregarCena(filePath);
+        return;
+    }
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "Erro", "Não foi possível abrir o arquivo selecionado.");
+    if (carregamento.isRunning()) {
+        QMessageBox::warning(this, "Aviso", "Já existe um desenho sendo carregado.");
         return;
     }
+    iniciarCarregamento(filePath);
+}
 
-    QTextStream in(&file);
-    int contador_retas = 0;
+void MainWindow::iniciarCarregamento(const QString& caminho)
+{
+    cancelarCarregamento = false;
+    retasCarregadas = 0;
+    ui->pushButton_carregarDesenho->setEnabled(false);
+    barraProgresso->setValue(0);
+    barraProgresso->show();
+    botaoCancelarCarregamento->setEnabled(true);
+    botaoCancelarCarregamento->show();
+    ui->statusbar->showMessage("Carregando desenho...");
+
+    // Cada parte analisada vira um lote entregue à thread da interface pela fila
+    // de eventos. Cada lote ocupa uma vaga de vagasLotes até ser todo inserido,
+    // então a análise nunca fica mais que LOTES_EM_VOO lotes à frente. Se a
+    // janela for destruída, os lotes pendentes são descartados.
+    const int geracao = ++geracaoCarregamento;
+    carregamento = QtConcurrent::run([this, caminho, geracao]() {
+        const qint64 tamanhoParte = 16 * 1024 * 1024;
+        // Espera em intervalos curtos para perceber um cancelamento (ou a janela sendo fechada).
+        auto esperarVaga = [this]() {
+            while (!vagasLotes.tryAcquire(1, 50)) {
+                if (cancelarCarregamento) return false;
+            }
+            return true;
+        };
+
+        int primeiro = 0;
+        CarregadorDesenho carregador;
+        carregador.carregarEmLotes(caminho, [&](const QVector<double>& segmentos,
+                                                qint64 bytesLidos, qint64 bytesTotal) {
+            if (!esperarVaga()) return false;
+            int base = primeiro;
+            primeiro += segmentos.size() / 4;
+            QMetaObject::invokeMethod(this, [this, segmentos, base, bytesLidos, bytesTotal, geracao]() {
+                receberLote(segmentos, 0, base, bytesLidos, bytesTotal, geracao);
+            }, Qt::QueuedConnection);
+            return !cancelarCarregamento;
+        }, tamanhoParte);
+
+        // Só conclui quando a interface terminou de inserir: todas as vagas voltaram.
+        int vagas = 0;
+        while (vagas < LOTES_EM_VOO && esperarVaga()) {
+            ++vagas;
+        }
+        vagasLotes.release(vagas);
 
-    QRegularExpression re("\\(\\s*([0-9.]+)\\s*,\\s*([0-9.]+)\\s*\\)\\s*\\(\\s*([0-9.]+)\\s*,\\s*([0-9.]+)\\s*\\)");
+        QString erro = cancelarCarregamento ? QString() : carregador.getErro();
+        QMetaObject::invokeMethod(this, [this, erro]() {
+            concluirCarregamento(erro);
+        }, Qt::QueuedConnection);
+    });
+}
 
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        QRegularExpressionMatch match = re.match(line);
+void MainWindow::receberLote(const QVector<double>& segmentos, int inicio, int primeiro, qint64 bytesLidos,
+                             qint64 bytesTotal, int geracao)
+{
+    // Lotes que já estavam na fila quando o usuário cancelou (ou de um
+    // carregamento anterior) são descartados, devolvendo a vaga.
+    if (cancelarCarregamento || geracao != geracaoCarregamento) {
+        vagasLotes.release();
+        return;
+    }
+    MEDIR_ETAPA("receber_lote");
+
+    // Um lote tem centenas de milhares de retas; cada evento insere só uma fatia.
+    int numSegmentos = segmentos.size() / 4;
+    int fim = std::min(numSegmentos, inicio + RETAS_POR_EVENTO);
+    if (fim > inicio) {
+        if (inicio == 0) {
+            armazem->reservar(2 * numSegmentos);
+            displayFile.reserve(displayFile.size() + numSegmentos);
+        }
+        modeloObjetos->comecarInsercao(fim - inicio);
+
+        const double* s0 = segmentos.constData() + 4 * inicio;
+        CaixaLimite caixaLote = {s0[0], s0[1], s0[0], s0[1]};
+        for (int i = inicio; i < fim; ++i) {
+            const double* s = segmentos.constData() + 4 * i;
+            QString nome = QString("Reta_arq_%1").arg(primeiro + i + 1);
+            RetaGrafica* reta = objetos->criarReta(nome, Ponto(s[0], s[1]), Ponto(s[2], s[3]));
+            displayFile.append(reta);
+            grade->inserir(reta);
+
+            const CaixaLimite& c = reta->getCaixa();
+            caixaLote.xmin = std::min(caixaLote.xmin, c.xmin);
+            caixaLote.ymin = std::min(caixaLote.ymin, c.ymin);
+            caixaLote.xmax = std::max(caixaLote.xmax, c.xmax);
+            caixaLote.ymax = std::max(caixaLote.ymax, c.ymax);
+        }
+        modeloObjetos->terminarInsercao();
+        retasCarregadas += fim - inicio;
 
-        if (match.hasMatch()) {
-            QString x1_str = match.captured(1);
-            QString y1_str = match.captured(2);
-            QString x2_str = match.captured(3);
-            QString y2_str = match.captured(4);
+        invalidarCaixa(caixaLote);
+    }
 
-            double x1 = x1_str.toDouble();
-            double y1 = y1_str.toDouble();
-            double x2 = x2_str.toDouble();
-            double y2 = y2_str.toDouble();
+    if (fim < numSegmentos) {
+        QMetaObject::invokeMethod(this, [this, segmentos, fim, primeiro, bytesLidos, bytesTotal, geracao]() {
+            receberLote(segmentos, fim, primeiro, bytesLidos, bytesTotal, geracao);
+        }, Qt::QueuedConnection);
+    } else {
+        vagasLotes.release();
+        barraProgresso->setValue(bytesTotal > 0 ? static_cast<int>(bytesLidos * 100 / bytesTotal) : 100);
+    }
+    ui->statusbar->showMessage(QString("Carregando desenho... %1 retas").arg(retasCarregadas));
+}
 
-            Ponto p1(x1, y1);
-            Ponto p2(x2, y2);
+void MainWindow::concluirCarregamento(const QString& erro)
+{
+    barraProgresso->hide();
+    botaoCancelarCarregamento->hide();
+    ui->pushButton_carregarDesenho->setEnabled(true);
+
+    if (!erro.isEmpty()) {
+        QMessageBox::warning(this, "Erro", erro);
+    }
+    if (cancelarCarregamento) {
+        ui->statusbar->showMessage(QString("Carregamento cancelado: %1 retas carregadas.").arg(retasCarregadas));
+    } else {
+        ui->statusbar->showMessage(QString("Desenho carregado: %1 retas.").arg(retasCarregadas));
+    }
+}
 
-            QString nome = QString("Reta_arq_%1").arg(++contador_retas);
+void MainWindow::carregarCena(const QString& caminho)
+{
+    MEDIR_ETAPA("carregar_cena");
+    QVector<ObjetoGrafico*> novos;
+    CenaBinaria cena;
+    EstadoWindow antes = estadoWindow();
+    if (!cena.carregar(caminho, objetos, novos, a_window)) {
+        QMessageBox::warning(this, "Erro", cena.getErro());
+        return;
+    }
+    // A cena traz a sua window; registrada como navegação, desfazer a leva de volta.
+    registrarComando(new ComandoWindow(antes, estadoWindow()));
+
+    displayFile.reserve(displayFile.size() + novos.size());
+    modeloObjetos->comecarInsercao(novos.size());
+    for (ObjetoGrafico* obj : novos) {
+        displayFile.append(obj);
+        grade->inserir(obj);
+    }
+    modeloObjetos->terminarInsercao();
+    modeloObjetos->linhaAlterada(0);
+
+    atualizarCamposWindow();
+    invalidarCena();
+}
 
-            displayFile.append(new RetaGrafica(nome, p1, p2));
+void MainWindow::atualizarCamposWindow()
+{
+    LimitesWindow limites = a_window->getLimites();
+    ui->lineEdit_w_xmin->setText(QString::number(limites.xmin));
+    ui->lineEdit_w_ymin->setText(QString::number(limites.ymin));
+    ui->lineEdit_w_xmax->setText(QString::number(limites.xmax));
+    ui->lineEdit_w_ymax->setText(QString::number(limites.ymax));
+
+    int v_xmin, v_ymin, v_xmax, v_ymax;
+    transformador->getViewport(v_xmin, v_ymin, v_xmax, v_ymax);
+    ui->lineEdit_v_xmin->setText(QString::number(v_xmin));
+    ui->lineEdit_v_ymin->setText(QString::number(v_ymin));
+    ui->lineEdit_v_xmax->setText(QString::number(v_xmax));
+    ui->lineEdit_v_ymax->setText(QString::number(v_ymax));
+}
+
+void MainWindow::on_pushButton_salvarCena_clicked()
+{
+    QString caminho = QFileDialog::getSaveFileName(this, "Salvar Cena", "", "Cenas (*.cgcena)");
+    if (caminho.isEmpty()) {
+        return;
+    }
+    if (!caminho.endsWith(".cgcena", Qt::CaseInsensitive)) {
+        caminho += ".cgcena";
+    }
+
+    // O arquivo guarda vértices do mundo: as transformações pendentes são
+    // aplicadas agora e as caixas, agora exatas, voltam para a grade.
+    for (ObjetoGrafico* obj : displayFile) {
+        if (obj != a_window && obj->temModelo()) {
+            obj->consolidar();
+            grade->atualizar(obj);
         }
     }
 
-    file.close();
+    CenaBinaria cena;
+    if (!cena.salvar(caminho, displayFile, a_window)) {
+        QMessageBox::warning(this, "Erro", cena.getErro());
+        return;
+    }
+    ui->statusbar->showMessage(QString("Cena salva: %1 objetos.").arg(displayFile.size() - 1));
+}
+
+void MainWindow::on_comboBox_clipping_currentIndexChanged(int index)
+{
+    if (index < 0) return;
+    clipper->setAlgoritmo(static_cast<AlgoritmoClipping>(index));
+    ui->statusbar->showMessage("Clipping de retas: " + Clipping::nomeAlgoritmo(clipper->getAlgoritmo()));
+    invalidarCena();
+}
 
-    atualizarListaObjetos();
-    update();
+void MainWindow::on_checkBox_renderParalelo_toggled(bool checked)
+{
+    Q_UNUSED(checked);
+    invalidarCena();
+}
+
+void MainWindow::on_checkBox_desempenho_toggled(bool checked)
+{
+    Instrumentacao::setAtiva(checked);
+    rotuloDesempenho->setVisible(checked);
+    // Redesenha tudo para o primeiro quadro medido já incluir a cena inteira.
+    if (checked) invalidarCena();
+}
+
+void MainWindow::on_pushButton_exportarTrace_clicked()
+{
+    QString caminho = QFileDialog::getSaveFileName(this, "Exportar Trace", "",
+                                                   "Trace do Chrome (*.json);;Planilha (*.csv)");
+    if (caminho.isEmpty()) {
+        return;
+    }
+
+    QString erro;
+    bool ok;
+    if (caminho.endsWith(".csv", Qt::CaseInsensitive)) {
+        ok = Instrumentacao::exportarCSV(caminho, &erro);
+    } else {
+        if (!caminho.endsWith(".json", Qt::CaseInsensitive)) {
+            caminho += ".json";
+        }
+        ok = Instrumentacao::exportarChromeTrace(caminho, &erro);
+    }
+    if (!ok) {
+        QMessageBox::warning(this, "Erro", erro);
+        return;
+    }
+    ui->statusbar->showMessage("Trace exportado: " + caminho);
+}
+
+void MainWindow::transformarSelecionado(int index, const Mat3& matriz, const QString& descricao)
+{
+    ObjetoGrafico* obj = displayFile[index];
+    transformarObjeto(obj, matriz);
+    registrarComando(new ComandoTransformacao(objetos->handle(obj), matriz, descricao));
+}
+
+EstadoWindow MainWindow::estadoWindow() const
+{
+    Ponto centro = a_window->calcularCentro();
+    EstadoWindow estado = {centro.getX(), centro.getY(), a_window->getLargura(), a_window->getAltura(),
+                           a_window->getAngulo(), {0, 0, 0, 0}};
+    transformador->getViewport(estado.viewport[0], estado.viewport[1], estado.viewport[2], estado.viewport[3]);
+    return estado;
+}
+
+void MainWindow::registrarComando(Comando* comando)
+{
+    historico->registrar(comando);
+    atualizarBotoesHistorico();
+}
+
+void MainWindow::atualizarBotoesHistorico()
+{
+    ui->pushButton_desfazer->setEnabled(historico->podeDesfazer());
+    ui->pushButton_refazer->setEnabled(historico->podeRefazer());
+    ui->pushButton_desfazer->setToolTip(historico->podeDesfazer() ? "Desfazer: " + historico->proximoDesfazer() : QString());
+    ui->pushButton_refazer->setToolTip(historico->podeRefazer() ? "Refazer: " + historico->proximoRefazer() : QString());
+}
+
+void MainWindow::on_pushButton_desfazer_clicked()
+{
+    QString descricao = historico->proximoDesfazer();
+    if (!historico->desfazer(*this)) return;
+    atualizarBotoesHistorico();
+    ui->statusbar->showMessage("Desfeito: " + descricao);
+}
+
+void MainWindow::on_pushButton_refazer_clicked()
+{
+    QString descricao = historico->proximoRefazer();
+    if (!historico->refazer(*this)) return;
+    atualizarBotoesHistorico();
+    ui->statusbar->showMessage("Refeito: " + descricao);
+}
+
+ObjetoGrafico* MainWindow::objetoDoHandle(const HandleObjeto& h) const
+{
+    return objetos->obter(h);
+}
+
+void MainWindow::transformarObjeto(ObjetoGrafico* obj, const Mat3& matriz)
+{
+    invalidarObjeto(obj);
+    obj->aplicarTransformacao(matriz);
+    grade->atualizar(obj);
+    invalidarObjeto(obj);
+}
+
+void MainWindow::definirVisibilidade(ObjetoGrafico* obj, bool visivel)
+{
+    obj->setVisivel(visivel);
+    modeloObjetos->linhaAlterada(displayFile.indexOf(obj));
+    grade->atualizar(obj);
+    invalidarObjeto(obj);
+}
+
+void MainWindow::definirWindow(const EstadoWindow& estado)
+{
+    a_window->definir(estado.centroX, estado.centroY, estado.largura, estado.altura, estado.angulo);
+    transformador->setViewport(estado.viewport[0], estado.viewport[1], estado.viewport[2], estado.viewport[3]);
+    atualizarCamposWindow();
+    invalidarCena();
+}
+
+CopiaObjeto MainWindow::removerObjeto(ObjetoGrafico* obj)
+{
+    int linha = displayFile.indexOf(obj);
+    int n = obj->getNumPontos();
+
+    CopiaObjeto copia;
+    copia.tipo = obj->getTipo();
+    copia.tipoCurva = copia.tipo == TipoObjeto::CURVA ? static_cast<CurvaGrafica*>(obj)->getTipoCurva() : TipoCurva::BEZIER;
+    copia.nome = obj->getNome();
+    copia.xs = QVector<double>(obj->getXs(), obj->getXs() + n);
+    copia.ys = QVector<double>(obj->getYs(), obj->getYs() + n);
+    copia.temModelo = obj->temModelo();
+    copia.modelo = obj->getModelo();
+    copia.preenchido = copia.tipo == TipoObjeto::POLIGONO && static_cast<PoligonoGrafico*>(obj)->isPreenchido();
+    copia.visivel = obj->isVisivel();
+    copia.linha = linha;
+
+    invalidarObjeto(obj);
+    grade->remover(obj);
+    if (objetoSobCursor == obj) {
+        objetoSobCursor = nullptr;
+    }
+    modeloObjetos->comecarRemocao(linha);
+    objetos->destruir(obj);
+    displayFile.removeAt(linha);
+    modeloObjetos->terminarRemocao();
+    if (armazem->desperdicio() > armazem->tamanho() / 2) {
+        armazem->compactar(displayFile);
+    }
+    return copia;
+}
+
+HandleObjeto MainWindow::restaurarObjeto(const CopiaObjeto& copia)
+{
+    ObjetoGrafico* obj = nullptr;
+    switch (copia.tipo) {
+    case TipoObjeto::PONTO:
+        obj = objetos->criarPonto(copia.nome, Ponto(copia.xs[0], copia.ys[0]));
+        break;
+    case TipoObjeto::RETA:
+        obj = objetos->criarReta(copia.nome, Ponto(copia.xs[0], copia.ys[0]), Ponto(copia.xs[1], copia.ys[1]));
+        break;
+    case TipoObjeto::POLIGONO:
+        obj = objetos->criarPoligono(copia.nome, copia.xs.constData(), copia.ys.constData(), copia.xs.size(),
+                                     copia.preenchido);
+        break;
+    case TipoObjeto::CURVA:
+        obj = objetos->criarCurva(copia.nome, copia.tipoCurva, copia.xs.constData(), copia.ys.constData(),
+                                  copia.xs.size());
+        break;
+    }
+    // Os vértices voltam em coordenadas do objeto, com a mesma matriz de modelo pendente.
+    if (copia.temModelo) {
+        obj->aplicarTransformacao(copia.modelo);
+    }
+    obj->setVisivel(copia.visivel);
+
+    int linha = std::clamp(copia.linha, 1, static_cast<int>(displayFile.size()));
+    modeloObjetos->comecarInsercaoEm(linha);
+    displayFile.insert(linha, obj);
+    modeloObjetos->terminarInsercao();
+    grade->inserir(obj);
+    invalidarObjeto(obj);
+    return objetos->handle(obj);
 }
@@ -4,22 +4,38 @@
 #include <QMainWindow>
 #include <QVector>
 #include <QMouseEvent>
-#include <QListWidgetItem>
 #include <QFileDialog>
-#include <QTextStream>
-#include <QRegularExpression>
+#include <QImage>
+#include <QRect>
+#include <QFuture>
+#include <QSemaphore>
+#include <QProgressBar>
+#include <QLabel>
+#include <QPushButton>
+#include <atomic>
 #include "objetografico.h"
+#include "armazemvertices.h"
+#include "armazemobjetos.h"
 #include "transformador.h"
 #include "windowgrafica.h"
 #include "clipping.h"
+#include "renderizador.h"
+#include "renderizadorparalelo.h"
+#include "gradeespacial.h"
+#include "carregadordesenho.h"
+#include "cenabinaria.h"
+#include "modeloobjetos.h"
+#include "selecao.h"
+#include "instrumentacao.h"
+#include "historico.h"
 
-enum class ModoDesenho { NENHUM, PONTO, RETA, POLIGONO };
+enum class ModoDesenho { NENHUM, PONTO, RETA, POLIGONO, CURVA };
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
 
-class MainWindow : public QMainWindow
+class MainWindow : public QMainWindow, private CenaHistorico
 {
     Q_OBJECT
 
@@ -37,25 +53,99 @@ private slots:
     void on_pushButton_rotacionar_clicked();
     void on_pushButton_addReta_clicked();
     void on_pushButton_addPoligono_clicked();
+    void on_pushButton_addCurva_clicked();
     void on_pushButton_finalizarDesenho_clicked();
     void on_checkBox_usarPontoEspecifico_toggled(bool checked);
     void on_pushButton_addPonto_clicked();
     void on_pushButton_excluir_clicked();
-    void on_listWidget_objetos_itemChanged(QListWidgetItem *item);
     void on_pushButton_aplicar_wv_clicked();
     void on_pushButton_carregarDesenho_clicked();
+    void on_pushButton_salvarCena_clicked();
+    void on_comboBox_clipping_currentIndexChanged(int index);
+    void on_checkBox_renderParalelo_toggled(bool checked);
+    void on_checkBox_desempenho_toggled(bool checked);
+    void on_pushButton_exportarTrace_clicked();
+    void on_pushButton_desfazer_clicked();
+    void on_pushButton_refazer_clicked();
 
 private:
-    void atualizarListaObjetos();
+    void adicionarObjeto(ObjetoGrafico* obj);
     void resetarModoDesenho();
+    void aplicarVisibilidade(int linha);
+    ObjetoGrafico* objetoEm(const QPoint& posCanvas);
+    void destacar(ObjetoGrafico* obj);
+    void invalidarDestaque(const ObjetoGrafico* obj);
+    void desenharDestaque(QPainter& painter, const ObjetoGrafico* obj, const QColor& cor) const;
+    void carregarCena(const QString& caminho);
+    // Mostra nos campos de window e viewport os valores em uso.
+    void atualizarCamposWindow();
+    void iniciarCarregamento(const QString& caminho);
+    void receberLote(const QVector<double>& segmentos, int inicio, int primeiro, qint64 bytesLidos,
+                     qint64 bytesTotal, int geracao);
+    void concluirCarregamento(const QString& erro);
+    void invalidarCena();
+    void invalidarObjeto(const ObjetoGrafico* obj);
+    void invalidarCaixa(const CaixaLimite& caixa);
+    void renderizarCena(const QRect& areaCanvas);
+    void atualizarPainelDesempenho();
+    void transformarSelecionado(int index, const Mat3& matriz, const QString& descricao);
+    EstadoWindow estadoWindow() const;
+    void registrarComando(Comando* comando);
+    void atualizarBotoesHistorico();
+
+    // CenaHistorico: as mesmas operações dos botões, sem registrar comandos.
+    ObjetoGrafico* objetoDoHandle(const HandleObjeto& h) const override;
+    void transformarObjeto(ObjetoGrafico* obj, const Mat3& matriz) override;
+    void definirVisibilidade(ObjetoGrafico* obj, bool visivel) override;
+    void definirWindow(const EstadoWindow& estado) override;
+    CopiaObjeto removerObjeto(ObjetoGrafico* obj) override;
+    HandleObjeto restaurarObjeto(const CopiaObjeto& copia) override;
 
     Ui::MainWindow *ui;
     QVector<ObjetoGrafico*> displayFile;
+    ModeloObjetos* modeloObjetos;
+    ArmazemVertices* armazem;
+    ArmazemObjetos* objetos;
+    GradeEspacial* grade;
     ModoDesenho modoDesenho;
     QVector<QPoint> pontosTemporarios;
     TransformadorCoordenadas* transformador;
 
     WindowGrafica* a_window;
     Clipping* clipper;
+    Renderizador* renderizador;
+    RenderizadorParalelo* renderizadorParalelo;
+
+    // Distância máxima, em pixels, entre o cursor e um objeto para selecioná-lo.
+    static constexpr double TOLERANCIA_SELECAO = 5.0;
+    SeletorObjetos* seletor;
+    ObjetoGrafico* objetoSobCursor;
+
+    Historico* historico;
+
+    // Cena já renderizada do canvas. Só é redesenhada quando a cena ou a vista
+    // mudam; o overlay de desenho é composto por cima a cada paintEvent.
+    QImage cena;
+    bool cenaSuja;
+    QRect regiaoSuja;
+
+    // Carregamento de desenho em segundo plano. A thread de trabalho só lê o
+    // arquivo; os objetos são criados aqui, lote a lote, na thread da interface.
+    QFuture<void> carregamento;
+    std::atomic<bool> cancelarCarregamento;
+    int retasCarregadas;
+    // Lotes analisados que podem esperar na fila ao mesmo tempo; a análise
+    // para enquanto a interface não consome, limitando a memória e a fila.
+    static constexpr int LOTES_EM_VOO = 2;
+    // Retas inseridas por evento; o resto do lote volta para a fila.
+    static constexpr int RETAS_POR_EVENTO = 4096;
+    QSemaphore vagasLotes;
+    // Identifica o carregamento corrente; lotes de um anterior são descartados.
+    int geracaoCarregamento;
+    QProgressBar* barraProgresso;
+    QPushButton* botaoCancelarCarregamento;
+
+    // Tempo do último quadro e percentis, na barra de status, com "Medir desempenho" marcado.
+    QLabel* rotuloDesempenho;
 };
 #endif // MAINWINDOW_H
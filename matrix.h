@@ -1,29 +1,64 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
-#include <vector>
 #include <cmath>
 
-class Matrix {
+// Vetor homogêneo (x, y, w) com armazenamento inline.
+struct Vec3 {
+    double x, y, w;
+
+    constexpr Vec3(double x = 0.0, double y = 0.0, double w = 1.0) : x(x), y(y), w(w) {}
+};
+
+// Matriz 3x3 de tamanho fixo para transformações afins 2D.
+// Não faz nenhuma alocação: cópias e produtos ficam inteiramente na pilha.
+class Mat3 {
 public:
-    Matrix();
+    constexpr Mat3() : m{{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}} {}
+
+    constexpr Mat3 operator*(const Mat3& other) const {
+        Mat3 result;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                result.m[i][j] = m[i][0] * other.m[0][j]
+                               + m[i][1] * other.m[1][j]
+                               + m[i][2] * other.m[2][j];
+            }
+        }
+        return result;
+    }
+
+    constexpr Vec3 operator*(const Vec3& v) const {
+        return Vec3(m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.w,
+                    m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.w,
+                    m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.w);
+    }
+
+    static constexpr Mat3 criarMatrizTranslacao(double dx, double dy) {
+        Mat3 t;
+        t.m[0][2] = dx;
+        t.m[1][2] = dy;
+        return t;
+    }
 
-    Matrix(int rows, int cols);
+    static constexpr Mat3 criarMatrizEscala(double sx, double sy) {
+        Mat3 s;
+        s.m[0][0] = sx;
+        s.m[1][1] = sy;
+        return s;
+    }
 
-    Matrix operator*(const Matrix& other) const;
+    static Mat3 criarMatrizRotacao(double anguloGraus);
 
-    static Matrix criarMatrizTranslacao(double dx, double dy);
-    static Matrix criarMatrizEscala(double sx, double sy);
-    static Matrix criarMatrizRotacao(double anguloGraus);
+    // Inversa pela adjunta. Devolve false (e não toca em 'resultado') se a
+    // matriz for singular ou tiver entradas não finitas.
+    bool inversa(Mat3& resultado) const;
 
-    double& at(int row, int col);
-    const double& at(int row, int col) const;
-    int getRows() const { return rows; }
-    int getCols() const { return cols; }
+    constexpr double& at(int row, int col) { return m[row][col]; }
+    constexpr const double& at(int row, int col) const { return m[row][col]; }
 
-protected:
-    int rows, cols;
-    std::vector<std::vector<double>> data;
+private:
+    double m[3][3];
 };
 
 #endif // MATRIX_H
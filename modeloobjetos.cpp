@@ -0,0 +1,73 @@
+#include "modeloobjetos.h"
+
+ModeloObjetos::ModeloObjetos(const QVector<ObjetoGrafico*>& objetos, QObject* parent)
+    : QAbstractListModel(parent), objetos(objetos), inserindo(false)
+{}
+
+int ModeloObjetos::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : objetos.size();
+}
+
+QVariant ModeloObjetos::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= objetos.size()) return QVariant();
+
+    const ObjetoGrafico* obj = objetos[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString("%1 (%2)").arg(obj->getNome()).arg(tipoParaString(obj->getTipo()));
+    case Qt::CheckStateRole:
+        return obj->isVisivel() ? Qt::Checked : Qt::Unchecked;
+    default:
+        return QVariant();
+    }
+}
+
+bool ModeloObjetos::setData(const QModelIndex& index, const QVariant& value, int role) {
+    if (!index.isValid() || index.row() >= objetos.size() || role != Qt::CheckStateRole) return false;
+
+    ObjetoGrafico* obj = objetos[index.row()];
+    bool visivel = value.toInt() == Qt::Checked;
+    if (obj->isVisivel() == visivel) return true;
+
+    obj->setVisivel(visivel);
+    emit dataChanged(index, index, {Qt::CheckStateRole});
+    emit visibilidadeAlterada(index.row());
+    return true;
+}
+
+Qt::ItemFlags ModeloObjetos::flags(const QModelIndex& index) const {
+    if (!index.isValid()) return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable | Qt::ItemNeverHasChildren;
+}
+
+void ModeloObjetos::comecarInsercao(int quantidade) {
+    inserindo = quantidade > 0;
+    if (inserindo) {
+        beginInsertRows(QModelIndex(), objetos.size(), objetos.size() + quantidade - 1);
+    }
+}
+
+void ModeloObjetos::comecarInsercaoEm(int linha) {
+    inserindo = true;
+    beginInsertRows(QModelIndex(), linha, linha);
+}
+
+void ModeloObjetos::terminarInsercao() {
+    if (inserindo) {
+        endInsertRows();
+        inserindo = false;
+    }
+}
+
+void ModeloObjetos::comecarRemocao(int linha) {
+    beginRemoveRows(QModelIndex(), linha, linha);
+}
+
+void ModeloObjetos::terminarRemocao() {
+    endRemoveRows();
+}
+
+void ModeloObjetos::linhaAlterada(int linha) {
+    QModelIndex i = index(linha);
+    emit dataChanged(i, i);
+}
@@ -0,0 +1,44 @@
+#ifndef MODELOOBJETOS_H
+#define MODELOOBJETOS_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include "objetografico.h"
+
+// Modelo da lista de objetos, lido direto do display file. Nenhum item é
+// criado por objeto: o texto e o estado de visibilidade são montados só
+// para as linhas que a view pede, então a lista aguenta milhões de objetos.
+//
+// O display file continua sendo alterado pela MainWindow; cada alteração deve
+// ficar entre o par comecar/terminar correspondente para a view ser avisada.
+class ModeloObjetos : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit ModeloObjetos(const QVector<ObjetoGrafico*>& objetos, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    // 'quantidade' objetos serão acrescentados ao fim do display file.
+    void comecarInsercao(int quantidade);
+    // Um objeto será inserido no display file na posição 'linha'.
+    void comecarInsercaoEm(int linha);
+    void terminarInsercao();
+    void comecarRemocao(int linha);
+    void terminarRemocao();
+    // Nome ou visibilidade do objeto mudaram fora da lista.
+    void linhaAlterada(int linha);
+
+signals:
+    // O usuário marcou ou desmarcou o objeto na lista; a visibilidade já foi aplicada.
+    void visibilidadeAlterada(int linha);
+
+private:
+    const QVector<ObjetoGrafico*>& objetos;
+    bool inserindo;
+};
+
+#endif // MODELOOBJETOS_H
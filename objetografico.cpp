@@ -1,21 +1,148 @@
 #include "objetografico.h"
+#include "simplificacao.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace {
+// Polígonos com menos vértices que isso não ganham pirâmide.
+const int MIN_VERTICES_LOD = 64;
+// Um nível só é guardado se reduzir o anterior em pelo menos 20%.
+const double REDUCAO_MINIMA_LOD = 0.8;
+// Limite de passos por segmento de curva, para um zoom extremo não gerar polilinhas sem fim.
+const int MAX_PASSOS_CURVA = 1024;
+
+// Avalia um polinômio cúbico em t = 0, h, 2h, ... só com somas: f é o valor
+// corrente e d1, d2, d3 suas diferenças adiante de primeira a terceira ordem.
+struct DiferencasAdiante {
+    double f, d1, d2, d3;
+
+    // Coordenada de um segmento de Bézier com pontos de controle p0..p3.
+    DiferencasAdiante(double p0, double p1, double p2, double p3, double h) {
+        // Base de potências: a t³ + b t² + c t + p0.
+        double a = -p0 + 3.0 * p1 - 3.0 * p2 + p3;
+        double b = 3.0 * p0 - 6.0 * p1 + 3.0 * p2;
+        double c = 3.0 * (p1 - p0);
+        double h2 = h * h, h3 = h2 * h;
+        f = p0;
+        d1 = a * h3 + b * h2 + c * h;
+        d3 = 6.0 * a * h3;
+        d2 = d3 + 2.0 * b * h2;
+    }
+
+    double avancar() {
+        f += d1;
+        d1 += d2;
+        d2 += d3;
+        return f;
+    }
+};
+
+// Passos para um segmento ficar a até 'tolerancia' da corda: o erro de uma
+// corda de parâmetro h é no máximo h²/8 * max|B''|, e |B''| <= 6 * 'curvatura'
+// (maior segunda diferença dos pontos de controle).
+int passosSegmento(double curvatura, double tolerancia) {
+    if (tolerancia <= 0.0) return MAX_PASSOS_CURVA;
+    double n = std::ceil(std::sqrt(0.75 * curvatura / tolerancia));
+    if (n >= MAX_PASSOS_CURVA) return MAX_PASSOS_CURVA;
+    return n >= 1.0 ? static_cast<int>(n) : 1;
+}
+
+// Chave do cache de tesselação: o expoente da maior potência de 2 que não
+// passa de 'tolerancia', ou INT_MIN se ela não for um número positivo.
+int expoenteTolerancia(double tolerancia) {
+    return tolerancia > 0.0 && std::isfinite(tolerancia) ? std::ilogb(tolerancia) : INT_MIN;
+}
+}
+
+CaixaLimite caixaTransformada(const Mat3& T, double xmin, double ymin, double xmax, double ymax) {
+    Ponto cantos[4] = {
+        T * Ponto(xmin, ymin), T * Ponto(xmax, ymin),
+        T * Ponto(xmax, ymax), T * Ponto(xmin, ymax)
+    };
+    CaixaLimite caixa{cantos[0].getX(), cantos[0].getY(), cantos[0].getX(), cantos[0].getY()};
+    for (int i = 1; i < 4; ++i) {
+        caixa.xmin = std::min(caixa.xmin, cantos[i].getX());
+        caixa.xmax = std::max(caixa.xmax, cantos[i].getX());
+        caixa.ymin = std::min(caixa.ymin, cantos[i].getY());
+        caixa.ymax = std::max(caixa.ymax, cantos[i].getY());
+    }
+    return caixa;
+}
 
 QString tipoParaString(TipoObjeto tipo) {
     switch (tipo) {
     case TipoObjeto::PONTO: return "Ponto";
     case TipoObjeto::RETA: return "Reta";
     case TipoObjeto::POLIGONO: return "Polígono";
+    case TipoObjeto::CURVA: return "Curva";
     default: return "Desconhecido";
     }
 }
 
-ObjetoGrafico::ObjetoGrafico(QString nome, TipoObjeto tipo)
-    : nome(nome), tipo(tipo), visivel(true)
+ObjetoGrafico::ObjetoGrafico(ArmazemVertices* armazem, QString nome, TipoObjeto tipo, int quantidade)
+    : nome(nome), tipo(tipo), armazem(armazem), inicio(armazem->alocar(quantidade)),
+    quantidade(quantidade), visivel(true), modeloAtivo(false), caixa{0, 0, 0, 0}, caixaSuja(true),
+    caixaLocal{0, 0, 0, 0}, caixaLocalSuja(true), versaoGeometria(0), indicePool(-1)
 {}
 
+ObjetoGrafico::~ObjetoGrafico() {
+    armazem->liberar(inicio, quantidade);
+}
+
 QString ObjetoGrafico::getNome() const { return nome; }
 TipoObjeto ObjetoGrafico::getTipo() const { return tipo; }
-QVector<Ponto>& ObjetoGrafico::getPontos() { return pontos; }
+
+void ObjetoGrafico::setPonto(int i, const Ponto& p) {
+    consolidar();
+    armazem->xs()[inicio + i] = p.getX();
+    armazem->ys()[inicio + i] = p.getY();
+    caixaSuja = true;
+    caixaLocalSuja = true;
+    ++versaoGeometria;
+}
+
+void ObjetoGrafico::setVertices(const double* xs, const double* ys) {
+    // Todos os vértices são substituídos, então a matriz de modelo pode ser descartada.
+    modelo = Mat3();
+    modeloAtivo = false;
+    std::copy(xs, xs + quantidade, armazem->xs() + inicio);
+    std::copy(ys, ys + quantidade, armazem->ys() + inicio);
+    caixaSuja = true;
+    caixaLocalSuja = true;
+    ++versaoGeometria;
+}
+
+void ObjetoGrafico::setCaixa(const CaixaLimite& c) {
+    caixaLocal = c;
+    caixaLocalSuja = false;
+    caixaSuja = true;
+}
+
+const CaixaLimite& ObjetoGrafico::getCaixaLocal() const {
+    if (caixaLocalSuja) {
+        const double* xs = getXs();
+        const double* ys = getYs();
+        caixaLocal = {xs[0], ys[0], xs[0], ys[0]};
+        for (int i = 1; i < quantidade; ++i) {
+            caixaLocal.xmin = std::min(caixaLocal.xmin, xs[i]);
+            caixaLocal.xmax = std::max(caixaLocal.xmax, xs[i]);
+            caixaLocal.ymin = std::min(caixaLocal.ymin, ys[i]);
+            caixaLocal.ymax = std::max(caixaLocal.ymax, ys[i]);
+        }
+        caixaLocalSuja = false;
+    }
+    return caixaLocal;
+}
+
+const CaixaLimite& ObjetoGrafico::getCaixa() const {
+    if (caixaSuja) {
+        const CaixaLimite& local = getCaixaLocal();
+        caixa = modeloAtivo ? caixaTransformada(modelo, local.xmin, local.ymin, local.xmax, local.ymax) : local;
+        caixaSuja = false;
+    }
+    return caixa;
+}
 
 void ObjetoGrafico::setVisivel(bool v) {
     visivel = v;
@@ -25,80 +152,219 @@ bool ObjetoGrafico::isVisivel() const {
     return visivel;
 }
 
-void ObjetoGrafico::aplicarTransformacao(const Matrix& matriz) {
-    for (Ponto& p : pontos) {
-        Matrix pontoComoMatriz = p;
-        Matrix resultado = matriz * pontoComoMatriz;
-        p.setX(resultado.at(0, 0));
-        p.setY(resultado.at(1, 0));
+void ObjetoGrafico::aplicarTransformacao(const Mat3& matriz) {
+    modelo = matriz * modelo;
+    modeloAtivo = true;
+    caixaSuja = true;
+}
+
+void ObjetoGrafico::consolidar() {
+    if (!modeloAtivo) return;
+    armazem->aplicarTransformacao(modelo, inicio, quantidade);
+    modelo = Mat3();
+    modeloAtivo = false;
+    caixaSuja = true;
+    caixaLocalSuja = true;
+    ++versaoGeometria;
+}
+
+void ObjetoGrafico::atualizarCaches() const {
+    getCaixa();
+}
+
+PontoGrafico::PontoGrafico(ArmazemVertices* armazem, QString nome, const Ponto& p)
+    : ObjetoGrafico(armazem, nome, TipoObjeto::PONTO, 1) {
+    setPonto(0, p);
+}
+
+Ponto PontoGrafico::calcularCentro() const {
+    return getPonto(0);
+}
+
+RetaGrafica::RetaGrafica(ArmazemVertices* armazem, QString nome, const Ponto& p1, const Ponto& p2)
+    : ObjetoGrafico(armazem, nome, TipoObjeto::RETA, 2) {
+    setPonto(0, p1);
+    setPonto(1, p2);
+}
+
+Ponto RetaGrafica::calcularCentro() const {
+    const double* xs = getXs();
+    const double* ys = getYs();
+    return paraMundo(Ponto((xs[0] + xs[1]) / 2.0, (ys[0] + ys[1]) / 2.0));
+}
+
+PoligonoGrafico::PoligonoGrafico(ArmazemVertices* armazem, QString nome, const QVector<Ponto>& vertices, bool preenchido)
+    : ObjetoGrafico(armazem, nome, TipoObjeto::POLIGONO, vertices.size()), preenchido(preenchido), versaoNiveis(-1) {
+    for (int i = 0; i < vertices.size(); ++i) {
+        setPonto(i, vertices[i]);
     }
 }
 
-PontoGrafico::PontoGrafico(QString nome, const Ponto& p)
-    : ObjetoGrafico(nome, TipoObjeto::PONTO) {
-    pontos.append(p);
+PoligonoGrafico::PoligonoGrafico(ArmazemVertices* armazem, QString nome, const double* xs, const double* ys, int n,
+                                 bool preenchido)
+    : ObjetoGrafico(armazem, nome, TipoObjeto::POLIGONO, n), preenchido(preenchido), versaoNiveis(-1) {
+    setVertices(xs, ys);
+}
+
+Ponto PoligonoGrafico::calcularCentro() const {
+    if (quantidade == 0) return Ponto(0, 0);
+    const double* xs = getXs();
+    const double* ys = getYs();
+    double somaX = 0, somaY = 0;
+    for (int i = 0; i < quantidade; ++i) {
+        somaX += xs[i];
+        somaY += ys[i];
+    }
+    // A média é preservada por transformações afins, então basta levá-la ao mundo.
+    return paraMundo(Ponto(somaX / quantidade, somaY / quantidade));
 }
 
-void PontoGrafico::desenhar(QPainter& painter) const {
-    if (pontos.isEmpty()) return;
+void PoligonoGrafico::atualizarCaches() const {
+    ObjetoGrafico::atualizarCaches();
+    if (versaoNiveis == versaoGeometria) return;
 
-    painter.save();
+    niveis.clear();
+    versaoNiveis = versaoGeometria;
+    if (quantidade < MIN_VERTICES_LOD) return;
 
-    const Ponto& p = pontos.first();
-    painter.setPen(QPen(painter.pen().color(), 5));
-    painter.drawPoint(p.getX(), p.getY());
+    // Tolerâncias dobram a cada nível, de diagonal/4096 até diagonal/8; cada
+    // nível é simplificado a partir do anterior. Tudo em coordenadas do objeto,
+    // então transformar o polígono não invalida a pirâmide.
+    const CaixaLimite& local = getCaixaLocal();
+    double diagonal = std::hypot(local.xmax - local.xmin, local.ymax - local.ymin);
+    const double* baseX = getXs();
+    const double* baseY = getYs();
+    int baseN = quantidade;
+    NivelDetalhe candidato;
+    for (double tolerancia = diagonal / 4096.0; tolerancia <= diagonal / 8.0; tolerancia *= 2.0) {
+        simplificarPoligono(baseX, baseY, baseN, tolerancia, candidato.x, candidato.y);
+        if (candidato.x.size() < 4) break;
+        if (candidato.x.size() > baseN * REDUCAO_MINIMA_LOD) continue;
 
-    painter.restore();
+        // Em cascata os erros se somam: no máximo o dobro da última tolerância.
+        candidato.tolerancia = 2.0 * tolerancia;
+        niveis.append(candidato);
+        baseX = niveis.last().x.constData();
+        baseY = niveis.last().y.constData();
+        baseN = niveis.last().x.size();
+    }
 }
 
-Ponto PontoGrafico::calcularCentro() const {
-    if (pontos.isEmpty()) return Ponto(0, 0);
-    return pontos.first();
+const NivelDetalhe* PoligonoGrafico::getNivel(double tolerancia) const {
+    if (versaoNiveis != versaoGeometria) return nullptr;
+    for (int i = niveis.size() - 1; i >= 0; --i) {
+        if (niveis[i].tolerancia <= tolerancia) return &niveis[i];
+    }
+    return nullptr;
 }
 
-RetaGrafica::RetaGrafica(QString nome, const Ponto& p1, const Ponto& p2)
-    : ObjetoGrafico(nome, TipoObjeto::RETA) {
-    pontos.append(p1);
-    pontos.append(p2);
+CurvaGrafica::CurvaGrafica(ArmazemVertices* armazem, QString nome, TipoCurva tipoCurva, const QVector<Ponto>& controle)
+    : ObjetoGrafico(armazem, nome, TipoObjeto::CURVA, controle.size()), tipoCurva(tipoCurva), expoenteCache(0),
+    versaoCache(-1) {
+    for (int i = 0; i < controle.size(); ++i) {
+        setPonto(i, controle[i]);
+    }
 }
 
-void RetaGrafica::desenhar(QPainter& painter) const {
-    if (pontos.size() < 2) return;
-    const Ponto& p1 = pontos[0];
-    const Ponto& p2 = pontos[1];
-    painter.drawLine(p1.getX(), p1.getY(), p2.getX(), p2.getY());
+CurvaGrafica::CurvaGrafica(ArmazemVertices* armazem, QString nome, TipoCurva tipoCurva, const double* xs,
+                           const double* ys, int n)
+    : ObjetoGrafico(armazem, nome, TipoObjeto::CURVA, n), tipoCurva(tipoCurva), expoenteCache(0), versaoCache(-1) {
+    setVertices(xs, ys);
 }
 
-Ponto RetaGrafica::calcularCentro() const {
-    if (pontos.size() < 2) return Ponto(0, 0);
-    const Ponto& p1 = pontos[0];
-    const Ponto& p2 = pontos[1];
-    return Ponto((p1.getX() + p2.getX()) / 2.0, (p1.getY() + p2.getY()) / 2.0);
+bool CurvaGrafica::quantidadeValida(TipoCurva tipoCurva, int n) {
+    if (n < 4) return false;
+    return tipoCurva == TipoCurva::BSPLINE || (n - 1) % 3 == 0;
 }
 
-PoligonoGrafico::PoligonoGrafico(QString nome, const QVector<Ponto>& vertices)
-    : ObjetoGrafico(nome, TipoObjeto::POLIGONO) {
-    pontos = vertices;
+int CurvaGrafica::getNumSegmentos() const {
+    if (quantidade < 4) return 0;
+    return tipoCurva == TipoCurva::BEZIER ? (quantidade - 1) / 3 : quantidade - 3;
 }
 
-void PoligonoGrafico::desenhar(QPainter& painter) const {
-    if (pontos.size() < 2) return;
-    for (int i = 0; i < pontos.size() - 1; ++i) {
-        const Ponto& p1 = pontos[i];
-        const Ponto& p2 = pontos[i+1];
-        painter.drawLine(p1.getX(), p1.getY(), p2.getX(), p2.getY());
+void CurvaGrafica::segmentoBezier(int i, double bx[4], double by[4]) const {
+    const double* xs = getXs();
+    const double* ys = getYs();
+    if (tipoCurva == TipoCurva::BEZIER) {
+        std::copy(xs + 3 * i, xs + 3 * i + 4, bx);
+        std::copy(ys + 3 * i, ys + 3 * i + 4, by);
+        return;
     }
-    if (pontos.size() > 2) {
-        painter.drawLine(pontos.last().getX(), pontos.last().getY(), pontos.first().getX(), pontos.first().getY());
+
+    // Segmento i da B-spline uniforme (pontos i..i+3) escrito na base de Bézier.
+    auto converter = [](const double* q, double* b) {
+        b[0] = (q[0] + 4.0 * q[1] + q[2]) / 6.0;
+        b[1] = (2.0 * q[1] + q[2]) / 3.0;
+        b[2] = (q[1] + 2.0 * q[2]) / 3.0;
+        b[3] = (q[1] + 4.0 * q[2] + q[3]) / 6.0;
+    };
+    converter(xs + i, bx);
+    converter(ys + i, by);
+}
+
+void CurvaGrafica::tesselar(double tolerancia, QVector<double>& xs, QVector<double>& ys) const {
+    // Potências de 2 como chave: o zoom precisa mudar pelo menos 2x para a curva ser refeita.
+    int expoente = expoenteTolerancia(tolerancia);
+    std::lock_guard<std::mutex> bloqueio(travaCache);
+    if (versaoCache != versaoGeometria || expoenteCache != expoente) {
+        atualizarCache(expoente);
     }
+    xs = cacheX;
+    ys = cacheY;
 }
 
-Ponto PoligonoGrafico::calcularCentro() const {
-    if (pontos.isEmpty()) return Ponto(0, 0);
+void CurvaGrafica::tesselacaoAtual(double tolerancia, QVector<double>& xs, QVector<double>& ys) const {
+    std::lock_guard<std::mutex> bloqueio(travaCache);
+    if (versaoCache != versaoGeometria) {
+        atualizarCache(expoenteTolerancia(tolerancia));
+    }
+    xs = cacheX;
+    ys = cacheY;
+}
+
+void CurvaGrafica::atualizarCache(int expoente) const {
+    double tolerancia = expoente == INT_MIN ? 0.0 : std::ldexp(1.0, expoente);
+    cacheX.clear();
+    cacheY.clear();
+    int segmentos = getNumSegmentos();
+    for (int s = 0; s < segmentos; ++s) {
+        double bx[4], by[4];
+        segmentoBezier(s, bx, by);
+        if (s == 0) {
+            cacheX.append(bx[0]);
+            cacheY.append(by[0]);
+        }
+
+        double curvatura = std::max(std::hypot(bx[0] - 2.0 * bx[1] + bx[2], by[0] - 2.0 * by[1] + by[2]),
+                                    std::hypot(bx[1] - 2.0 * bx[2] + bx[3], by[1] - 2.0 * by[2] + by[3]));
+        int n = passosSegmento(curvatura, tolerancia);
+        DiferencasAdiante fx(bx[0], bx[1], bx[2], bx[3], 1.0 / n);
+        DiferencasAdiante fy(by[0], by[1], by[2], by[3], 1.0 / n);
+        for (int k = 1; k < n; ++k) {
+            cacheX.append(fx.avancar());
+            cacheY.append(fy.avancar());
+        }
+        // A ponta é o ponto de controle exato, sem o erro acumulado das somas.
+        cacheX.append(bx[3]);
+        cacheY.append(by[3]);
+    }
+    versaoCache = versaoGeometria;
+    expoenteCache = expoente;
+}
+
+double CurvaGrafica::toleranciaPadrao() const {
+    const CaixaLimite& local = getCaixaLocal();
+    return std::hypot(local.xmax - local.xmin, local.ymax - local.ymin) / 1024.0;
+}
+
+Ponto CurvaGrafica::calcularCentro() const {
+    if (quantidade == 0) return Ponto(0, 0);
+    const double* xs = getXs();
+    const double* ys = getYs();
     double somaX = 0, somaY = 0;
-    for (const Ponto& p : pontos) {
-        somaX += p.getX();
-        somaY += p.getY();
+    for (int i = 0; i < quantidade; ++i) {
+        somaX += xs[i];
+        somaY += ys[i];
     }
-    return Ponto(somaX / pontos.size(), somaY / pontos.size());
+    return paraMundo(Ponto(somaX / quantidade, somaY / quantidade));
 }
@@ -3,62 +3,202 @@
 
 #include <QString>
 #include <QVector>
-#include <QPainter>
+#include <mutex>
 #include "ponto.h"
 #include "matrix.h"
+#include "armazemvertices.h"
 
-enum class TipoObjeto { PONTO, RETA, POLIGONO };
+enum class TipoObjeto { PONTO, RETA, POLIGONO, CURVA };
+
+// Caixa alinhada aos eixos, em coordenadas do mundo.
+struct CaixaLimite {
+    double xmin, ymin, xmax, ymax;
+
+    bool intersecta(const CaixaLimite& outra) const {
+        return xmin <= outra.xmax && outra.xmin <= xmax
+            && ymin <= outra.ymax && outra.ymin <= ymax;
+    }
+};
+
+// Caixa alinhada aos eixos que contém a caixa dada depois de transformada por T.
+CaixaLimite caixaTransformada(const Mat3& T, double xmin, double ymin, double xmax, double ymax);
 
 QString tipoParaString(TipoObjeto tipo);
 
+template <typename T> class PoolObjetos;
+
 class ObjetoGrafico {
+    friend class ArmazemVertices;
+    template <typename T> friend class PoolObjetos;
+
 public:
-    ObjetoGrafico(QString nome, TipoObjeto tipo);
-    virtual ~ObjetoGrafico() = default;
+    ObjetoGrafico(ArmazemVertices* armazem, QString nome, TipoObjeto tipo, int quantidade);
+    ObjetoGrafico(const ObjetoGrafico&) = delete;
+    ObjetoGrafico& operator=(const ObjetoGrafico&) = delete;
+    virtual ~ObjetoGrafico();
 
-    virtual void desenhar(QPainter& painter) const = 0;
     virtual Ponto calcularCentro() const = 0;
 
-    virtual ObjetoGrafico* clone() const = 0;
-
-    void aplicarTransformacao(const Matrix& matriz);
+    // Só compõe 'matriz' na matriz de modelo do objeto, em O(1); os vértices
+    // no armazém não são tocados até consolidar().
+    void aplicarTransformacao(const Mat3& matriz);
+    // Aplica a matriz de modelo aos vértices do armazém e volta à identidade.
+    void consolidar();
+    bool temModelo() const { return modeloAtivo; }
+    const Mat3& getModelo() const { return modelo; }
 
     QString getNome() const;
     TipoObjeto getTipo() const;
-    QVector<Ponto>& getPontos();
+
+    int getNumPontos() const { return quantidade; }
+    int getInicio() const { return inicio; }
+    // Vértices como estão no armazém, em coordenadas do objeto: para chegar ao
+    // mundo ainda falta a matriz de modelo (se temModelo()).
+    const double* getXs() const { return armazem->xs() + inicio; }
+    const double* getYs() const { return armazem->ys() + inicio; }
+    // Vértice em coordenadas do mundo.
+    Ponto getPonto(int i) const { return paraMundo(Ponto(getXs()[i], getYs()[i])); }
+    // 'p' em coordenadas do mundo; consolida a matriz de modelo antes, se houver.
+    void setPonto(int i, const Ponto& p);
+    // Substitui todos os vértices (quantidade = getNumPontos()), em coordenadas do mundo.
+    void setVertices(const double* xs, const double* ys);
+
+    // Caixas em cache; transformar ou mover vértices as marca como sujas e elas
+    // são recalculadas só na próxima consulta. A caixa do mundo é a caixa
+    // local transformada pela matriz de modelo, então pode sobrar um pouco
+    // quando há rotação, mas nunca faltar.
+    const CaixaLimite& getCaixa() const;
+    const CaixaLimite& getCaixaLocal() const;
+    // Aproveita uma caixa local já conhecida (por exemplo, lida de um arquivo de cena).
+    void setCaixa(const CaixaLimite& c);
+
+    // Recalcula tudo o que é derivado da geometria e guardado em cache. A grade
+    // chama isto ao indexar o objeto, então a renderização (inclusive em várias
+    // threads) só lê os caches.
+    virtual void atualizarCaches() const;
 
     void setVisivel(bool visivel);
     bool isVisivel() const;
 
+    // Vaga no pool do ArmazemObjetos, ou -1 se o objeto não veio de um pool.
+    int getIndicePool() const { return indicePool; }
+
 protected:
     QString nome;
     TipoObjeto tipo;
-    QVector<Ponto> pontos;
+    ArmazemVertices* armazem;
+    int inicio;
+    int quantidade;
     bool visivel;
+
+    Ponto paraMundo(const Ponto& p) const { return modeloAtivo ? Ponto(modelo * p) : p; }
+
+    Mat3 modelo;
+    bool modeloAtivo;
+
+    mutable CaixaLimite caixa;
+    mutable bool caixaSuja;
+    mutable CaixaLimite caixaLocal;
+    mutable bool caixaLocalSuja;
+
+    // Incrementada a cada mudança nos vértices; caches derivados guardam a versão de origem.
+    int versaoGeometria;
+
+private:
+    int indicePool;
 };
 
 class PontoGrafico : public ObjetoGrafico {
 public:
-    PontoGrafico(QString nome, const Ponto& p);
-    void desenhar(QPainter& painter) const override;
+    PontoGrafico(ArmazemVertices* armazem, QString nome, const Ponto& p);
     Ponto calcularCentro() const override;
-    ObjetoGrafico* clone() const override { return new PontoGrafico(*this); }
 };
 
 class RetaGrafica : public ObjetoGrafico {
 public:
-    RetaGrafica(QString nome, const Ponto& p1, const Ponto& p2);
-    void desenhar(QPainter& painter) const override;
+    RetaGrafica(ArmazemVertices* armazem, QString nome, const Ponto& p1, const Ponto& p2);
     Ponto calcularCentro() const override;
-    ObjetoGrafico* clone() const override { return new RetaGrafica(*this); }
+};
+
+// Versão simplificada de um polígono, boa enquanto 'tolerancia' (em unidades
+// do mundo) for menor que meio pixel.
+struct NivelDetalhe {
+    double tolerancia;
+    QVector<double> x;
+    QVector<double> y;
 };
 
 class PoligonoGrafico : public ObjetoGrafico {
 public:
-    PoligonoGrafico(QString nome, const QVector<Ponto>& vertices);
-    void desenhar(QPainter& painter) const override;
+    PoligonoGrafico(ArmazemVertices* armazem, QString nome, const QVector<Ponto>& vertices, bool preenchido = false);
+    PoligonoGrafico(ArmazemVertices* armazem, QString nome, const double* xs, const double* ys, int n,
+                    bool preenchido = false);
+    Ponto calcularCentro() const override;
+
+    bool isPreenchido() const { return preenchido; }
+    void setPreenchido(bool p) { preenchido = p; }
+
+    void atualizarCaches() const override;
+
+    // Nível mais simples com tolerância até 'tolerancia', ou nullptr para usar
+    // todos os vértices (polígono pequeno ou pirâmide desatualizada).
+    const NivelDetalhe* getNivel(double tolerancia) const;
+
+private:
+    bool preenchido;
+
+    // Pirâmide de Douglas-Peucker, da tolerância menor para a maior.
+    mutable QVector<NivelDetalhe> niveis;
+    mutable int versaoNiveis;
+};
+
+enum class TipoCurva { BEZIER, BSPLINE };
+
+// Curva cúbica aberta dada pelos pontos de controle, que ficam no armazém
+// como os vértices dos outros objetos: transformar a curva é transformar só
+// eles. Bézier por partes usa 3k+1 pontos (segmentos emendados nas pontas);
+// B-spline uniforme, qualquer quantidade a partir de 4. A curva está dentro do
+// fecho convexo dos pontos de controle, então a caixa deles vale para ela.
+class CurvaGrafica : public ObjetoGrafico {
+public:
+    CurvaGrafica(ArmazemVertices* armazem, QString nome, TipoCurva tipoCurva, const QVector<Ponto>& controle);
+    CurvaGrafica(ArmazemVertices* armazem, QString nome, TipoCurva tipoCurva, const double* xs, const double* ys,
+                 int n);
     Ponto calcularCentro() const override;
-    ObjetoGrafico* clone() const override { return new PoligonoGrafico(*this); }
+
+    TipoCurva getTipoCurva() const { return tipoCurva; }
+    int getNumSegmentos() const;
+    static bool quantidadeValida(TipoCurva tipoCurva, int n);
+
+    // Polilinha em coordenadas do objeto que se afasta da curva no máximo
+    // 'tolerancia'. A tolerância é arredondada para baixo a uma potência de 2
+    // e o resultado fica em cache até a curva mudar ou a tolerância cair em
+    // outra potência. Pode ser chamada de várias threads ao mesmo tempo; as
+    // cópias devolvidas compartilham os dados do cache.
+    void tesselar(double tolerancia, QVector<double>& xs, QVector<double>& ys) const;
+    // Como tesselar(), mas aceita o cache com qualquer tolerância se ele estiver
+    // em dia com a curva; 'tolerancia' só vale se for preciso tesselar. Serve a
+    // quem só precisa de uma aproximação (seleção, destaque) sem desfazer o
+    // cache montado pelo Renderizador para o zoom atual.
+    void tesselacaoAtual(double tolerancia, QVector<double>& xs, QVector<double>& ys) const;
+    // Tolerância para quem não tem a escala da viewport à mão: uma fração do
+    // tamanho da curva, em coordenadas do objeto.
+    double toleranciaPadrao() const;
+
+private:
+    // Refaz o cache para a tolerância 2^expoente (ou a menor possível, se
+    // expoente = INT_MIN). Chamada com travaCache bloqueada.
+    void atualizarCache(int expoente) const;
+    // Pontos de Bézier do segmento 'i', em coordenadas do objeto.
+    void segmentoBezier(int i, double bx[4], double by[4]) const;
+
+    TipoCurva tipoCurva;
+
+    mutable std::mutex travaCache;
+    mutable QVector<double> cacheX;
+    mutable QVector<double> cacheY;
+    mutable int expoenteCache;
+    mutable int versaoCache;
 };
 
 #endif // OBJETOGRAFICO_H
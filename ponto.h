@@ -3,15 +3,16 @@
 
 #include "matrix.h"
 
-class Ponto : public Matrix {
+class Ponto : public Vec3 {
 public:
-    Ponto(double x = 0.0, double y = 0.0);
+    constexpr Ponto(double x = 0.0, double y = 0.0) : Vec3(x, y, 1.0) {}
+    constexpr Ponto(const Vec3& v) : Vec3(v) {}
 
-    double getX() const;
-    double getY() const;
+    constexpr double getX() const { return x; }
+    constexpr double getY() const { return y; }
 
-    void setX(double x);
-    void setY(double y);
+    constexpr void setX(double novoX) { x = novoX; }
+    constexpr void setY(double novoY) { y = novoY; }
 };
 
 #endif // PONTO_H
@@ -0,0 +1,212 @@
+#include "renderizacaolote.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QImage>
+#include <QPainter>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include "armazemobjetos.h"
+#include "armazemvertices.h"
+#include "carregadordesenho.h"
+#include "cenabinaria.h"
+#include "gradeespacial.h"
+#include "renderizador.h"
+#include "transformador.h"
+
+namespace {
+// Desenho sem extensão (um ponto ou uma reta vertical, por exemplo): a
+// window ganha essa folga para não ter largura ou altura zero.
+const double FOLGA_WINDOW = 1.0;
+
+bool ehCena(const QString& caminho) {
+    return caminho.endsWith(".cgcena", Qt::CaseInsensitive);
+}
+}
+
+RenderizacaoLote::RenderizacaoLote(const OpcoesRenderizacaoLote& opcoes)
+    : opcoes(opcoes)
+{}
+
+QStringList RenderizacaoLote::expandirEntradas(const QStringList& caminhos) {
+    QStringList arquivos;
+    for (const QString& caminho : caminhos) {
+        QFileInfo info(caminho);
+        if (!info.isDir()) {
+            arquivos.append(caminho);
+            continue;
+        }
+        QDir diretorio(caminho);
+        const QStringList nomes = diretorio.entryList({"*.txt", "*.cgcena"}, QDir::Files, QDir::Name);
+        for (const QString& nome : nomes) {
+            arquivos.append(diretorio.filePath(nome));
+        }
+    }
+    return arquivos;
+}
+
+QString RenderizacaoLote::caminhoSaida(const QString& nome) const {
+    return QDir(opcoes.diretorioSaida).filePath(nome + ".png");
+}
+
+QStringList RenderizacaoLote::caminhosSaida(const QStringList& entradas) const {
+    // Sem distinguir maiúsculas, como no sistema de arquivos do Windows.
+    QHash<QString, int> usosNome;
+    for (const QString& entrada : entradas) {
+        ++usosNome[QFileInfo(entrada).completeBaseName().toLower()];
+    }
+
+    QStringList saidas;
+    QSet<QString> ocupadas;
+    for (const QString& entrada : entradas) {
+        QFileInfo info(entrada);
+        QString nome = usosNome.value(info.completeBaseName().toLower()) > 1 ? info.fileName() : info.completeBaseName();
+        QString saida = caminhoSaida(nome);
+        if (ocupadas.contains(saida.toLower())) {
+            saidas.append(QString());
+        } else {
+            ocupadas.insert(saida.toLower());
+            saidas.append(saida);
+        }
+    }
+    return saidas;
+}
+
+int RenderizacaoLote::executar(const QStringList& entradas, const ReceptorResultado& concluido) const {
+    // Pool próprio: limita quantas cenas estão carregadas ao mesmo tempo e deixa
+    // o pool global livre para a análise paralela dentro do CarregadorDesenho.
+    QThreadPool pool;
+    pool.setMaxThreadCount(std::max(1, opcoes.threads));
+
+    // Saídas decididas antes de começar: duas threads nunca gravam o mesmo PNG.
+    const QStringList saidas = caminhosSaida(entradas);
+    QVector<int> fila(entradas.size());
+    std::iota(fila.begin(), fila.end(), 0);
+
+    std::mutex trava;
+    std::atomic<int> falhas(0);
+    QtConcurrent::blockingMap(&pool, fila, [&](int& i) {
+        ResultadoRenderizacao r;
+        if (saidas[i].isEmpty()) {
+            r.entrada = entradas[i];
+            r.objetos = 0;
+            r.milissegundos = 0;
+            r.erro = "Outra entrada com o mesmo nome já é gravada em "
+                   + caminhoSaida(QFileInfo(entradas[i]).fileName()) + "; renomeie o arquivo.";
+        } else {
+            r = renderizar(entradas[i], saidas[i]);
+        }
+        if (!r.erro.isEmpty()) ++falhas;
+        if (concluido) {
+            std::lock_guard<std::mutex> bloqueio(trava);
+            concluido(r);
+        }
+    });
+    return falhas;
+}
+
+ResultadoRenderizacao RenderizacaoLote::renderizar(const QString& entrada) const {
+    return renderizar(entrada, caminhoSaida(QFileInfo(entrada).completeBaseName()));
+}
+
+ResultadoRenderizacao RenderizacaoLote::renderizar(const QString& entrada, const QString& saida) const {
+    ResultadoRenderizacao r;
+    r.entrada = entrada;
+    r.saida = saida;
+    r.objetos = 0;
+    r.milissegundos = 0;
+
+    QElapsedTimer cronometro;
+    cronometro.start();
+
+    // Declarados nesta ordem para a destruição respeitar as dependências:
+    // os objetos vivem no armazém de objetos, que usa o de vértices.
+    ArmazemVertices vertices;
+    ArmazemObjetos objetos(&vertices);
+    GradeEspacial grade;
+    WindowGrafica window(&vertices, "Window", Ponto(0, 0), Ponto(1, 1));
+    QVector<ObjetoGrafico*> lista;
+
+    if (ehCena(entrada)) {
+        CenaBinaria cena;
+        if (!cena.carregar(entrada, &objetos, lista, &window)) {
+            r.erro = cena.getErro();
+            return r;
+        }
+    } else {
+        CarregadorDesenho carregador;
+        if (!carregador.carregar(entrada)) {
+            r.erro = carregador.getErro();
+            return r;
+        }
+        const QVector<double>& segmentos = carregador.getSegmentos();
+        int n = carregador.getNumSegmentos();
+        vertices.reservar(2 * n);
+        lista.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            const double* s = segmentos.constData() + 4 * i;
+            lista.append(objetos.criarReta(QString(), Ponto(s[0], s[1]), Ponto(s[2], s[3])));
+        }
+
+        // Sem window salva, o desenho inteiro fica visível.
+        if (n > 0) {
+            CaixaLimite caixa = lista[0]->getCaixa();
+            for (const ObjetoGrafico* obj : lista) {
+                const CaixaLimite& c = obj->getCaixa();
+                caixa.xmin = std::min(caixa.xmin, c.xmin);
+                caixa.ymin = std::min(caixa.ymin, c.ymin);
+                caixa.xmax = std::max(caixa.xmax, c.xmax);
+                caixa.ymax = std::max(caixa.ymax, c.ymax);
+            }
+            if (caixa.xmax - caixa.xmin <= 0.0) {
+                caixa.xmin -= FOLGA_WINDOW;
+                caixa.xmax += FOLGA_WINDOW;
+            }
+            if (caixa.ymax - caixa.ymin <= 0.0) {
+                caixa.ymin -= FOLGA_WINDOW;
+                caixa.ymax += FOLGA_WINDOW;
+            }
+            window.atualizarLimites(caixa.xmin, caixa.ymin, caixa.xmax, caixa.ymax);
+        }
+    }
+    r.objetos = lista.size();
+
+    for (ObjetoGrafico* obj : lista) {
+        grade.inserir(obj);
+    }
+    if (opcoes.usarWindow) {
+        window.atualizarLimites(opcoes.window.xmin, opcoes.window.ymin, opcoes.window.xmax, opcoes.window.ymax);
+    }
+    window.setVisivel(false);
+
+    QRect viewport = opcoes.viewport.isEmpty() ? QRect(QPoint(0, 0), opcoes.tamanho) : opcoes.viewport;
+    TransformadorCoordenadas transformador;
+    transformador.setWindow(-1.0, -1.0, 1.0, 1.0);
+    transformador.setViewport(viewport.left(), viewport.top(),
+                              viewport.left() + viewport.width(), viewport.top() + viewport.height());
+
+    Clipping clipper;
+    clipper.setAlgoritmo(opcoes.algoritmo);
+    Renderizador renderizador(clipper);
+
+    QImage imagem(opcoes.tamanho, QImage::Format_ARGB32_Premultiplied);
+    imagem.fill(opcoes.fundo);
+    {
+        QPainter painter(&imagem);
+        painter.setClipRect(viewport);
+        renderizador.desenharCena(painter, grade, &window, transformador.getTransformacao());
+    }
+
+    if (!imagem.save(r.saida, "PNG")) {
+        r.erro = "Não foi possível gravar " + r.saida;
+        return r;
+    }
+    r.milissegundos = cronometro.elapsed();
+    return r;
+}
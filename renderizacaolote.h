@@ -0,0 +1,66 @@
+#ifndef RENDERIZACAOLOTE_H
+#define RENDERIZACAOLOTE_H
+
+#include <QColor>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include "clipping.h"
+#include "windowgrafica.h"
+
+struct OpcoesRenderizacaoLote {
+    QString diretorioSaida;
+    QSize tamanho;             // da imagem gravada
+    QRect viewport;            // dentro da imagem; vazio = imagem inteira
+    bool usarWindow;           // senão: a window da cena, ou a caixa do desenho
+    LimitesWindow window;
+    AlgoritmoClipping algoritmo;
+    QColor fundo;
+    int threads;
+};
+
+struct ResultadoRenderizacao {
+    QString entrada;
+    QString saida;
+    int objetos;
+    qint64 milissegundos;
+    QString erro;              // vazio se deu certo
+};
+
+// Renderiza desenhos (.txt) e cenas (.cgcena) em PNG, sem janela. Cada arquivo
+// passa pelo mesmo caminho do canvas: armazém, grade, window, Renderizador e
+// Clipping, pintando num QImage.
+//
+// Os arquivos são distribuídos por um pool próprio de 'threads' threads, cada
+// uma com um arquivo por vez, então no máximo 'threads' cenas ficam em memória.
+class RenderizacaoLote {
+public:
+    typedef std::function<void(const ResultadoRenderizacao&)> ReceptorResultado;
+
+    explicit RenderizacaoLote(const OpcoesRenderizacaoLote& opcoes);
+
+    // Chama 'concluido' depois de cada arquivo, de uma thread do pool, mas
+    // nunca duas vezes ao mesmo tempo. Devolve quantos arquivos falharam.
+    int executar(const QStringList& entradas, const ReceptorResultado& concluido) const;
+
+    ResultadoRenderizacao renderizar(const QString& entrada) const;
+    ResultadoRenderizacao renderizar(const QString& entrada, const QString& saida) const;
+
+    // PNG de cada entrada, na mesma ordem: <nome>.png, ou <nome>.<extensão>.png
+    // quando duas entradas dariam o mesmo nome (casa.txt e casa.cgcena). Fica
+    // vazio para quem ainda assim repetiria a saída de uma entrada anterior
+    // (a/casa.txt e b/casa.txt): essa entrada falha em vez de sobrescrever a outra.
+    QStringList caminhosSaida(const QStringList& entradas) const;
+
+    // Troca diretórios pelos desenhos e cenas que contêm (sem descer em subdiretórios).
+    static QStringList expandirEntradas(const QStringList& caminhos);
+
+private:
+    QString caminhoSaida(const QString& nome) const;
+
+    OpcoesRenderizacaoLote opcoes;
+};
+
+#endif // RENDERIZACAOLOTE_H
@@ -0,0 +1,359 @@
+#include "renderizador.h"
+#include "instrumentacao.h"
+#include "transformacaolote.h"
+#include <algorithm>
+#include <cmath>
+
+Renderizador::Renderizador(const Clipping& clipper)
+    : clipper(clipper),
+    limites(WindowGrafica::limitesNormalizados()),
+    toleranciaLOD(0.0),
+    penObjetos(Qt::green, 2),
+    penPontos(Qt::green, 5),
+    penWindow(Qt::cyan, 2, Qt::DashDotLine),
+    brushPreenchimento(QColor(0, 128, 0))
+{}
+
+namespace {
+// Maior fator pelo qual a parte linear de T pode esticar um comprimento.
+double escalaMaxima(const Mat3& T) {
+    double a = T.at(0, 0), b = T.at(0, 1), c = T.at(1, 0), d = T.at(1, 1);
+    double meio = (a * a + b * b + c * c + d * d) / 2.0;
+    double det = a * d - b * c;
+    return std::sqrt(meio + std::sqrt(std::max(0.0, meio * meio - det * det)));
+}
+}
+
+QRectF Renderizador::regiaoViewport(const CaixaLimite& caixa, const WindowGrafica* window, const Mat3& T_vp) {
+    CaixaLimite c = caixaTransformada(T_vp * window->getMatrizNormalizacao(),
+                                      caixa.xmin, caixa.ymin, caixa.xmax, caixa.ymax);
+    return QRectF(c.xmin, c.ymin, c.xmax - c.xmin, c.ymax - c.ymin)
+        .normalized().adjusted(-MARGEM_TRACO, -MARGEM_TRACO, MARGEM_TRACO, MARGEM_TRACO);
+}
+
+CaixaLimite Renderizador::caixaConsulta(const WindowGrafica* window, const QRectF& regiao) const {
+    CaixaLimite caixa = window->getLimites();
+    if (regiao.isEmpty()) return caixa;
+
+    // Viewport ou window degenerada: sem como levar a região ao mundo, consulta a window inteira.
+    Mat3 inversa;
+    if (!T_total.inversa(inversa)) return caixa;
+
+    // Objetos logo fora da região ainda podem invadi-la com a espessura do traço.
+    QRectF r = regiao.adjusted(-MARGEM_TRACO, -MARGEM_TRACO, MARGEM_TRACO, MARGEM_TRACO);
+    CaixaLimite mundo = caixaTransformada(inversa, r.left(), r.top(), r.right(), r.bottom());
+    caixa.xmin = std::max(caixa.xmin, mundo.xmin);
+    caixa.ymin = std::max(caixa.ymin, mundo.ymin);
+    caixa.xmax = std::min(caixa.xmax, mundo.xmax);
+    caixa.ymax = std::min(caixa.ymax, mundo.ymax);
+    return caixa;
+}
+
+void Renderizador::desenharCena(QPainter& painter, const GradeEspacial& grade,
+                                const WindowGrafica* window, const Mat3& T_viewport,
+                                const QRectF& regiao) {
+    T_norm = window->getMatrizNormalizacao();
+    T_vp = T_viewport;
+    T_total = T_vp * T_norm;
+    limites = WindowGrafica::limitesNormalizados();
+
+    // clear() preserva a capacidade, então os buffers só crescem.
+    linhas.clear();
+    pontos.clear();
+    bordaWindow.clear();
+    candidatos.clear();
+    verticesTrechos.clear();
+    trechos.clear();
+    loteX1.clear();
+    loteY1.clear();
+    loteX2.clear();
+    loteY2.clear();
+    pontosAgregados.clear();
+    celulasOcupadas.clear();
+
+    // Pixels por unidade do mundo (a transformação total é uma similaridade
+    // quando a window não é esticada; o determinante dá a média nas duas direções).
+    double escala = std::sqrt(std::abs(T_total.at(0, 0) * T_total.at(1, 1) - T_total.at(0, 1) * T_total.at(1, 0)));
+    toleranciaLOD = escala > 0.0 ? 0.5 / escala : 0.0;
+
+    if (window->isVisivel()) {
+        processarWindow();
+    }
+
+    CaixaLimite consulta = caixaConsulta(window, regiao);
+    if (consulta.xmin <= consulta.xmax && consulta.ymin <= consulta.ymax) {
+        MEDIR_ETAPA("consultar_grade");
+        double celulaEmPixels = grade.getTamanhoCelula() * escala;
+        if (celulaEmPixels < 1.0) {
+            // Células menores que um pixel: os objetos pequenos viram um ponto por
+            // célula ocupada do nível cujo lado chega a pelo menos um pixel.
+            int nivel = static_cast<int>(std::ceil(std::log2(1.0 / celulaEmPixels)));
+            grade.consultarOcupacao(consulta, std::min(nivel, GradeEspacial::NUM_NIVEIS - 1), celulasOcupadas);
+            processarOcupacao();
+            grade.consultar(consulta, candidatos, false);
+        } else {
+            grade.consultar(consulta, candidatos);
+        }
+    }
+
+    CONTAR(OBJETOS_CANDIDATOS, candidatos.size());
+    {
+        MEDIR_ETAPA("processar_objetos");
+        for (const ObjetoGrafico* obj : candidatos) {
+            if (!obj->isVisivel()) continue;
+
+            switch (obj->getTipo()) {
+            case TipoObjeto::PONTO:
+                processarPonto(obj);
+                break;
+            case TipoObjeto::RETA:
+                processarReta(obj);
+                break;
+            case TipoObjeto::POLIGONO:
+                processarPoligono(obj);
+                break;
+            case TipoObjeto::CURVA:
+                processarCurva(obj);
+                break;
+            }
+        }
+    }
+    {
+        MEDIR_ETAPA("recortar_retas");
+        recortarLoteRetas();
+    }
+
+    // Uma troca de estado e uma chamada por grupo.
+    MEDIR_ETAPA("submeter_painter");
+    if (!bordaWindow.isEmpty()) {
+        painter.setPen(penWindow);
+        painter.drawLines(bordaWindow.constData(), bordaWindow.size());
+    }
+
+    painter.setPen(penObjetos);
+    if (!trechos.isEmpty()) {
+        painter.setBrush(brushPreenchimento);
+        for (const Trecho& t : trechos) {
+            painter.drawPolygon(verticesTrechos.constData() + t.inicio, t.tamanho);
+        }
+        painter.setBrush(Qt::NoBrush);
+    }
+    if (!linhas.isEmpty()) {
+        painter.drawLines(linhas.constData(), linhas.size());
+    }
+
+    if (!pontosAgregados.isEmpty()) {
+        painter.drawPoints(pontosAgregados);
+    }
+
+    if (!pontos.isEmpty()) {
+        painter.setPen(penPontos);
+        painter.drawPoints(pontos);
+    }
+}
+
+void Renderizador::processarOcupacao() {
+    CONTAR(VERTICES_TRANSFORMADOS, celulasOcupadas.size());
+    for (const CaixaLimite& c : celulasOcupadas) {
+        Ponto p = T_norm * Ponto((c.xmin + c.xmax) / 2.0, (c.ymin + c.ymax) / 2.0);
+        if (clipper.clipPonto(p, limites)) {
+            p = T_vp * p;
+            pontosAgregados.append(QPointF(p.getX(), p.getY()));
+        }
+    }
+}
+
+void Renderizador::processarPonto(const ObjetoGrafico* obj) {
+    CONTAR(VERTICES_TRANSFORMADOS, 1);
+    Ponto p = T_norm * obj->getPonto(0);
+    if (clipper.clipPonto(p, limites)) {
+        p = T_vp * p;
+        pontos.append(QPointF(p.getX(), p.getY()));
+    }
+}
+
+Renderizador::Classificacao Renderizador::classificar(const CaixaLimite& caixa) const {
+    CaixaLimite c = caixaTransformada(T_norm, caixa.xmin, caixa.ymin, caixa.xmax, caixa.ymax);
+    const double xmin = c.xmin, ymin = c.ymin, xmax = c.xmax, ymax = c.ymax;
+
+    if (xmax < limites.xmin || xmin > limites.xmax || ymax < limites.ymin || ymin > limites.ymax) {
+        return Classificacao::FORA;
+    }
+    if (xmin >= limites.xmin && xmax <= limites.xmax && ymin >= limites.ymin && ymax <= limites.ymax) {
+        return Classificacao::DENTRO;
+    }
+    return Classificacao::PARCIAL;
+}
+
+void Renderizador::processarReta(const ObjetoGrafico* obj) {
+    Classificacao c = classificar(obj->getCaixa());
+    if (c == Classificacao::FORA) {
+        CONTAR(OBJETOS_DESCARTADOS, 1);
+        return;
+    }
+    CONTAR(VERTICES_TRANSFORMADOS, 2);
+
+    if (c == Classificacao::DENTRO) {
+        Ponto p1 = T_total * obj->getPonto(0);
+        Ponto p2 = T_total * obj->getPonto(1);
+        linhas.append(QLineF(p1.getX(), p1.getY(), p2.getX(), p2.getY()));
+        return;
+    }
+
+    Ponto p1 = T_norm * obj->getPonto(0);
+    Ponto p2 = T_norm * obj->getPonto(1);
+    loteX1.append(p1.getX());
+    loteY1.append(p1.getY());
+    loteX2.append(p2.getX());
+    loteY2.append(p2.getY());
+}
+
+void Renderizador::recortarLoteRetas() {
+    int n = loteX1.size();
+    if (n == 0) return;
+
+    loteAceito.resize(n);
+    clipper.clipRetas(loteX1.data(), loteY1.data(), loteX2.data(), loteY2.data(), n, limites, loteAceito.data());
+
+    for (int i = 0; i < n; ++i) {
+        if (!loteAceito[i]) continue;
+        Ponto p1 = T_vp * Ponto(loteX1[i], loteY1[i]);
+        Ponto p2 = T_vp * Ponto(loteX2[i], loteY2[i]);
+        linhas.append(QLineF(p1.getX(), p1.getY(), p2.getX(), p2.getY()));
+    }
+}
+
+void Renderizador::matrizesObjeto(const ObjetoGrafico* obj, Mat3& M_total, Mat3& M_norm, double& tolerancia) const {
+    // Os vértices estão em coordenadas do objeto: a matriz de modelo entra
+    // junto com as do quadro, sem reescrever o armazém.
+    M_total = T_total;
+    M_norm = T_norm;
+    tolerancia = toleranciaLOD;
+    if (obj->temModelo()) {
+        M_total = T_total * obj->getModelo();
+        M_norm = T_norm * obj->getModelo();
+        double escala = escalaMaxima(obj->getModelo());
+        if (escala > 0.0) tolerancia /= escala;
+    }
+}
+
+void Renderizador::processarPoligono(const ObjetoGrafico* obj) {
+    if (obj->getNumPontos() < 2) return;
+
+    Classificacao c = classificar(obj->getCaixa());
+    if (c == Classificacao::FORA) {
+        CONTAR(OBJETOS_DESCARTADOS, 1);
+        return;
+    }
+
+    const PoligonoGrafico* poligono = static_cast<const PoligonoGrafico*>(obj);
+    bool preenchido = poligono->isPreenchido();
+
+    Mat3 M_total, M_norm;
+    double tolerancia;
+    matrizesObjeto(obj, M_total, M_norm, tolerancia);
+
+    // Nível de detalhe cujo erro não passa de meio pixel na escala atual.
+    const NivelDetalhe* nivel = poligono->getNivel(tolerancia);
+    const double* xs = nivel ? nivel->x.constData() : obj->getXs();
+    const double* ys = nivel ? nivel->y.constData() : obj->getYs();
+    int n = nivel ? nivel->x.size() : obj->getNumPontos();
+    normX.resize(n);
+    normY.resize(n);
+
+    if (c == Classificacao::DENTRO) {
+        // Inteiramente visível: vai direto para a viewport, sem recorte.
+        transformarLote(M_total, xs, ys, normX.data(), normY.data(), n);
+        if (preenchido) {
+            trechos.append({static_cast<int>(verticesTrechos.size()), n});
+            for (int i = 0; i < n; ++i) {
+                verticesTrechos.append(QPointF(normX[i], normY[i]));
+            }
+        } else {
+            for (int i = 0, j = n - 1; i < n; j = i++) {
+                linhas.append(QLineF(normX[j], normY[j], normX[i], normY[i]));
+            }
+        }
+        return;
+    }
+
+    // Normaliza todos os vértices do polígono de uma vez e recorta o polígono inteiro.
+    transformarLote(M_norm, xs, ys, normX.data(), normY.data(), n);
+    clipper.clipPoligono(normX.constData(), normY.constData(), n, limites, recortado, auxiliar);
+    emitirRecortado(preenchido);
+}
+
+void Renderizador::processarCurva(const ObjetoGrafico* obj) {
+    Classificacao c = classificar(obj->getCaixa());
+    if (c == Classificacao::FORA) {
+        CONTAR(OBJETOS_DESCARTADOS, 1);
+        return;
+    }
+
+    Mat3 M_total, M_norm;
+    double tolerancia;
+    matrizesObjeto(obj, M_total, M_norm, tolerancia);
+
+    // Polilinha com erro de até meio pixel, refeita só quando a curva ou o zoom mudam.
+    static_cast<const CurvaGrafica*>(obj)->tesselar(tolerancia, curvaX, curvaY);
+    int n = curvaX.size();
+    if (n < 2) return;
+    normX.resize(n);
+    normY.resize(n);
+
+    if (c == Classificacao::DENTRO) {
+        transformarLote(M_total, curvaX.constData(), curvaY.constData(), normX.data(), normY.data(), n);
+        for (int i = 1; i < n; ++i) {
+            linhas.append(QLineF(normX[i - 1], normY[i - 1], normX[i], normY[i]));
+        }
+        return;
+    }
+
+    // Cruza a borda: os trechos entram no lote e são recortados junto com as retas.
+    transformarLote(M_norm, curvaX.constData(), curvaY.constData(), normX.data(), normY.data(), n);
+    for (int i = 1; i < n; ++i) {
+        loteX1.append(normX[i - 1]);
+        loteY1.append(normY[i - 1]);
+        loteX2.append(normX[i]);
+        loteY2.append(normY[i]);
+    }
+}
+
+void Renderizador::emitirRecortado(bool preenchido) {
+    int m = recortado.tamanho();
+    if (m < 2) return;
+
+    auto paraViewport = [this](int i) {
+        Ponto p = T_vp * Ponto(recortado.x[i], recortado.y[i]);
+        return QPointF(p.getX(), p.getY());
+    };
+
+    if (preenchido) {
+        trechos.append({static_cast<int>(verticesTrechos.size()), m});
+        for (int i = 0; i < m; ++i) {
+            verticesTrechos.append(paraViewport(i));
+        }
+        return;
+    }
+
+    // Contorno sem preenchimento: as arestas sobre a borda da window não
+    // pertencem ao polígono e ficam de fora do lote de linhas.
+    QPointF anterior = paraViewport(m - 1);
+    for (int i = 0; i < m; ++i) {
+        QPointF atual = paraViewport(i);
+        if (!recortado.borda[i]) {
+            linhas.append(QLineF(anterior, atual));
+        }
+        anterior = atual;
+    }
+}
+
+void Renderizador::processarWindow() {
+    // Em coordenadas normalizadas a window é sempre o quadrado [-1, 1].
+    static const Ponto cantos[4] = {Ponto(-1, -1), Ponto(1, -1), Ponto(1, 1), Ponto(-1, 1)};
+    for (int i = 0; i < 4; ++i) {
+        Ponto p1 = T_vp * cantos[i];
+        Ponto p2 = T_vp * cantos[(i + 1) % 4];
+        bordaWindow.append(QLineF(p1.getX(), p1.getY(), p2.getX(), p2.getY()));
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef RENDERIZADOR_H
+#define RENDERIZADOR_H
+
+#include <QPainter>
+#include <QVector>
+#include <QLineF>
+#include <QPointF>
+#include <QPolygonF>
+#include <QRectF>
+#include <QPen>
+#include <QBrush>
+#include <QColor>
+#include "objetografico.h"
+#include "windowgrafica.h"
+#include "clipping.h"
+#include "gradeespacial.h"
+
+// Desenha o display file lendo a geometria original direto do armazém.
+// Os vértices são levados para coordenadas normalizadas da window, recortados
+// contra [-1, 1] e só então mapeados para a viewport. O resultado vai para
+// buffers reaproveitados entre quadros, então um repaint estável não aloca.
+// Os buffers são agrupados por estado de caneta e cada grupo é enviado ao
+// QPainter numa única chamada (drawLines / drawPoints).
+class Renderizador {
+public:
+    explicit Renderizador(const Clipping& clipper);
+
+    // Folga, em pixels, para a espessura das canetas ao redor da caixa de um objeto.
+    static constexpr double MARGEM_TRACO = 4.0;
+
+    // Só os objetos que a grade aponta como próximos da window são processados.
+    // Se 'regiao' (em coordenadas de viewport) não for vazia, a consulta à grade
+    // é restrita a ela; o chamador deve recortar o painter na mesma região.
+    void desenharCena(QPainter& painter, const GradeEspacial& grade,
+                      const WindowGrafica* window, const Mat3& T_vp,
+                      const QRectF& regiao = QRectF());
+
+    // Retângulo de viewport coberto por uma caixa do mundo, já com MARGEM_TRACO.
+    static QRectF regiaoViewport(const CaixaLimite& caixa, const WindowGrafica* window, const Mat3& T_vp);
+
+private:
+    enum class Classificacao { FORA, DENTRO, PARCIAL };
+
+    // Compara a caixa do objeto com a window em coordenadas normalizadas,
+    // permitindo aceitar ou rejeitar o objeto inteiro sem recortar aresta por aresta.
+    Classificacao classificar(const CaixaLimite& caixa) const;
+    CaixaLimite caixaConsulta(const WindowGrafica* window, const QRectF& regiao) const;
+
+    void processarOcupacao();
+    void processarPonto(const ObjetoGrafico* obj);
+    void processarReta(const ObjetoGrafico* obj);
+    void processarPoligono(const ObjetoGrafico* obj);
+    void processarCurva(const ObjetoGrafico* obj);
+    // Matrizes do quadro compostas com a de modelo do objeto, e a tolerância
+    // de meio pixel levada para as coordenadas do objeto.
+    void matrizesObjeto(const ObjetoGrafico* obj, Mat3& M_total, Mat3& M_norm, double& tolerancia) const;
+    void processarWindow();
+    void emitirRecortado(bool preenchido);
+    void recortarLoteRetas();
+
+    const Clipping& clipper;
+
+    // Estado do quadro corrente.
+    Mat3 T_norm;
+    Mat3 T_vp;
+    Mat3 T_total;
+    LimitesWindow limites;
+    double toleranciaLOD; // meio pixel, em unidades do mundo
+
+    QPen penObjetos;
+    QPen penPontos;
+    QPen penWindow;
+    QBrush brushPreenchimento;
+
+    // Polígono preenchido, com os vértices já em coordenadas de viewport.
+    // Contornos sem preenchimento não viram trechos: suas arestas vão para 'linhas'.
+    struct Trecho {
+        int inicio;
+        int tamanho;
+    };
+
+    QVector<ObjetoGrafico*> candidatos;
+    QVector<QLineF> linhas;       // penObjetos: retas, curvas e contornos de polígonos
+    QPolygonF pontos;             // penPontos
+    QPolygonF pontosAgregados;    // penObjetos: células ocupadas por objetos pequenos
+    QVector<QLineF> bordaWindow;  // penWindow
+    QVector<double> normX;
+    QVector<double> normY;
+    // Polilinha da curva corrente, compartilhada com o cache da própria curva.
+    QVector<double> curvaX;
+    QVector<double> curvaY;
+    // Retas que cruzam a borda, em coordenadas normalizadas, recortadas juntas no fim do quadro.
+    QVector<double> loteX1;
+    QVector<double> loteY1;
+    QVector<double> loteX2;
+    QVector<double> loteY2;
+    QVector<unsigned char> loteAceito;
+    QVector<QPointF> verticesTrechos;  // penObjetos + brushPreenchimento
+    QVector<Trecho> trechos;
+    QVector<CaixaLimite> celulasOcupadas;
+    PoligonoRecortado recortado;
+    PoligonoRecortado auxiliar;
+};
+
+#endif // RENDERIZADOR_H
@@ -0,0 +1,60 @@
+#include "renderizadorparalelo.h"
+#include <QPainter>
+#include <QtConcurrent>
+
+RenderizadorParalelo::RenderizadorParalelo(const Clipping& clipper, int tamanhoTile)
+    : clipper(clipper), tamanhoTile(tamanhoTile)
+{}
+
+RenderizadorParalelo::~RenderizadorParalelo() {
+    for (Renderizador* r : renderizadores) {
+        delete r;
+    }
+}
+
+void RenderizadorParalelo::desenharCena(QImage& destino, const QPoint& origem, const QRect& regiao,
+                                        const GradeEspacial& grade, const WindowGrafica* window, const Mat3& T_vp) {
+    // Os tiles são cortados em pixels da imagem, alinhados para fora, para
+    // cobrirem a região inteira também com escala fracionária.
+    const qreal escala = destino.devicePixelRatio();
+    const QRect pixels = QRectF((regiao.left() - origem.x()) * escala, (regiao.top() - origem.y()) * escala,
+                                regiao.width() * escala, regiao.height() * escala)
+                             .toAlignedRect().intersected(destino.rect());
+
+    tiles.clear();
+    for (int y = pixels.top(); y <= pixels.bottom(); y += tamanhoTile) {
+        for (int x = pixels.left(); x <= pixels.right(); x += tamanhoTile) {
+            QRect area = QRect(x, y, tamanhoTile, tamanhoTile).intersected(pixels);
+            if (renderizadores.size() <= tiles.size()) {
+                renderizadores.append(new Renderizador(clipper));
+            }
+            tiles.append({area, renderizadores[tiles.size()]});
+        }
+    }
+    if (tiles.isEmpty()) return;
+
+    // Única escrita em cache compartilhado; depois disso as threads só leem.
+    window->getLimites();
+
+    // bits() pode desanexar a imagem, por isso é chamado uma vez, fora das threads.
+    uchar* base = destino.bits();
+    const qsizetype bytesPorLinha = destino.bytesPerLine();
+    const int bytesPorPixel = destino.depth() / 8;
+    const QImage::Format formato = destino.format();
+
+    QtConcurrent::blockingMap(tiles, [&](Tile& t) {
+        uchar* inicio = base + t.area.top() * bytesPorLinha + t.area.left() * bytesPorPixel;
+        QImage fatia(inicio, t.area.width(), t.area.height(), bytesPorLinha, formato);
+        fatia.fill(Qt::transparent);
+
+        // Pixels do tile -> coordenadas de viewport.
+        QPainter painter(&fatia);
+        painter.translate(-t.area.left(), -t.area.top());
+        painter.setClipRect(t.area);
+        painter.scale(escala, escala);
+        painter.translate(-origem.x(), -origem.y());
+        QRectF consulta(origem.x() + t.area.left() / escala, origem.y() + t.area.top() / escala,
+                        t.area.width() / escala, t.area.height() / escala);
+        t.renderizador->desenharCena(painter, grade, window, T_vp, consulta);
+    });
+}
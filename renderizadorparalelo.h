@@ -0,0 +1,42 @@
+#ifndef RENDERIZADORPARALELO_H
+#define RENDERIZADORPARALELO_H
+
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <QVector>
+#include "renderizador.h"
+
+// Divide a região a redesenhar em tiles e renderiza cada um numa thread do
+// pool global. Cada tile tem o seu próprio Renderizador (buffers por quadro)
+// e pinta direto na fatia correspondente da imagem de destino, então não
+// há cópia final: quando o mapa termina, a imagem já está completa.
+//
+// Durante a renderização a grade, o armazém e os objetos são só lidos. Os caches
+// dos objetos da grade (caixa, níveis de detalhe) estão sempre atualizados, pois
+// inserir/atualizar chamam atualizarCaches(); a caixa da window é atualizada aqui
+// antes de disparar as threads.
+class RenderizadorParalelo {
+public:
+    explicit RenderizadorParalelo(const Clipping& clipper, int tamanhoTile = 128);
+    ~RenderizadorParalelo();
+
+    // 'origem' é a posição, em coordenadas de viewport, do pixel (0, 0) de
+    // 'destino'; 'regiao' também está em coordenadas de viewport, que valem
+    // destino.devicePixelRatio() pixels da imagem cada.
+    void desenharCena(QImage& destino, const QPoint& origem, const QRect& regiao,
+                      const GradeEspacial& grade, const WindowGrafica* window, const Mat3& T_vp);
+
+private:
+    struct Tile {
+        QRect area;  // pixels da imagem de destino
+        Renderizador* renderizador;
+    };
+
+    const Clipping& clipper;
+    int tamanhoTile;
+    QVector<Renderizador*> renderizadores;  // reaproveitados entre quadros
+    QVector<Tile> tiles;
+};
+
+#endif // RENDERIZADORPARALELO_H
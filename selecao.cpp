@@ -0,0 +1,99 @@
+#include "selecao.h"
+#include "simplificacao.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Regra par-ímpar: conta quantas arestas uma semirreta horizontal a partir de (x, y) cruza.
+bool dentroPoligono(const double* xs, const double* ys, int n, double x, double y) {
+    bool dentro = false;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        if ((ys[i] > y) != (ys[j] > y)
+            && x < (xs[j] - xs[i]) * (y - ys[i]) / (ys[j] - ys[i]) + xs[i]) {
+            dentro = !dentro;
+        }
+    }
+    return dentro;
+}
+}
+
+double SeletorObjetos::distancia(const ObjetoGrafico* obj, double x, double y) {
+    const int n = obj->getNumPontos();
+
+    switch (obj->getTipo()) {
+    case TipoObjeto::PONTO: {
+        Ponto p = obj->getPonto(0);
+        return std::hypot(p.getX() - x, p.getY() - y);
+    }
+    case TipoObjeto::RETA: {
+        Ponto p1 = obj->getPonto(0), p2 = obj->getPonto(1);
+        return distanciaSegmento(x, y, p1.getX(), p1.getY(), p2.getX(), p2.getY());
+    }
+    case TipoObjeto::POLIGONO: {
+        if (static_cast<const PoligonoGrafico*>(obj)->isPreenchido()) {
+            // Estar dentro não muda com transformações afins: o teste é feito
+            // nas coordenadas do objeto, levando para lá o ponto consultado.
+            Ponto local(x, y);
+            bool inversivel = true;
+            if (obj->temModelo()) {
+                Mat3 inversa;
+                inversivel = obj->getModelo().inversa(inversa);
+                if (inversivel) local = inversa * local;
+            }
+            if (inversivel && dentroPoligono(obj->getXs(), obj->getYs(), n, local.getX(), local.getY())) {
+                return 0.0;
+            }
+        }
+        // Distâncias não são preservadas por escala, então as arestas são medidas no mundo.
+        double menor = INFINITY;
+        Ponto anterior = obj->getPonto(n - 1);
+        for (int i = 0; i < n; ++i) {
+            Ponto atual = obj->getPonto(i);
+            menor = std::min(menor, distanciaSegmento(x, y, anterior.getX(), anterior.getY(),
+                                                      atual.getX(), atual.getY()));
+            anterior = atual;
+        }
+        return menor;
+    }
+    case TipoObjeto::CURVA: {
+        // A polilinha do último quadro basta para escolher com o mouse; sem
+        // ela, uma com erro de uma fração do tamanho da curva.
+        const CurvaGrafica* curva = static_cast<const CurvaGrafica*>(obj);
+        QVector<double> xs, ys;
+        curva->tesselacaoAtual(curva->toleranciaPadrao(), xs, ys);
+
+        double menor = INFINITY;
+        Ponto anterior;
+        for (int i = 0; i < xs.size(); ++i) {
+            Ponto atual(xs[i], ys[i]);
+            if (obj->temModelo()) atual = obj->getModelo() * atual;
+            if (i > 0) {
+                menor = std::min(menor, distanciaSegmento(x, y, anterior.getX(), anterior.getY(),
+                                                          atual.getX(), atual.getY()));
+            }
+            anterior = atual;
+        }
+        return menor;
+    }
+    }
+    return INFINITY;
+}
+
+ObjetoGrafico* SeletorObjetos::selecionar(const GradeEspacial& grade, double x, double y, double tolerancia,
+                                          bool incluirPequenos) {
+    candidatos.clear();
+    CaixaLimite regiao = {x - tolerancia, y - tolerancia, x + tolerancia, y + tolerancia};
+    grade.consultar(regiao, candidatos, incluirPequenos);
+
+    ObjetoGrafico* escolhido = nullptr;
+    double menor = tolerancia;
+    for (ObjetoGrafico* obj : candidatos) {
+        if (!obj->isVisivel()) continue;
+        double d = distancia(obj, x, y);
+        if (d <= menor) {
+            menor = d;
+            escolhido = obj;
+        }
+    }
+    return escolhido;
+}
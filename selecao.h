@@ -0,0 +1,27 @@
+#ifndef SELECAO_H
+#define SELECAO_H
+
+#include <QVector>
+#include "objetografico.h"
+#include "gradeespacial.h"
+
+// Responde "qual objeto está sob o cursor" consultando a grade só numa caixa
+// do tamanho da tolerância ao redor do ponto; os poucos candidatos são então
+// testados de forma exata (distância ao ponto/segmento/contorno e, para
+// polígonos preenchidos, ponto dentro do polígono).
+class SeletorObjetos {
+public:
+    // Objeto visível mais próximo de (x, y), em coordenadas do mundo, a até
+    // 'tolerancia'; nullptr se não houver. Com incluirPequenos = false os objetos
+    // que a grade agrega na pirâmide de ocupação são ignorados.
+    ObjetoGrafico* selecionar(const GradeEspacial& grade, double x, double y, double tolerancia,
+                              bool incluirPequenos = true);
+
+    // Distância de (x, y) ao objeto; 0 dentro de um polígono preenchido.
+    static double distancia(const ObjetoGrafico* obj, double x, double y);
+
+private:
+    QVector<ObjetoGrafico*> candidatos;
+};
+
+#endif // SELECAO_H
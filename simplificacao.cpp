@@ -0,0 +1,75 @@
+#include "simplificacao.h"
+#include <cmath>
+
+double distanciaSegmento(double px, double py, double ax, double ay, double bx, double by) {
+    double dx = bx - ax, dy = by - ay;
+    double comprimento2 = dx * dx + dy * dy;
+    double t = 0.0;
+    if (comprimento2 > 0.0) {
+        t = ((px - ax) * dx + (py - ay) * dy) / comprimento2;
+        t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+    }
+    double ex = ax + t * dx - px, ey = ay + t * dy - py;
+    return std::sqrt(ex * ex + ey * ey);
+}
+
+void simplificarPoligono(const double* xs, const double* ys, int n, double tolerancia,
+                         QVector<double>& saidaX, QVector<double>& saidaY) {
+    saidaX.clear();
+    saidaY.clear();
+    if (n <= 3) {
+        for (int i = 0; i < n; ++i) {
+            saidaX.append(xs[i]);
+            saidaY.append(ys[i]);
+        }
+        return;
+    }
+
+    // O contorno é aberto no vértice 0 e no vértice mais distante dele; as duas
+    // cadeias resultantes são simplificadas separadamente. O índice n é o vértice 0 de novo.
+    auto x = [&](int i) { return xs[i == n ? 0 : i]; };
+    auto y = [&](int i) { return ys[i == n ? 0 : i]; };
+
+    int oposto = 1;
+    double maior = -1.0;
+    for (int i = 1; i < n; ++i) {
+        double dx = xs[i] - xs[0], dy = ys[i] - ys[0];
+        double d = dx * dx + dy * dy;
+        if (d > maior) {
+            maior = d;
+            oposto = i;
+        }
+    }
+
+    QVector<char> manter(n + 1, 0);
+    manter[0] = manter[oposto] = manter[n] = 1;
+
+    struct Faixa { int i, j; };
+    QVector<Faixa> pilha;
+    pilha.append({0, oposto});
+    pilha.append({oposto, n});
+    while (!pilha.isEmpty()) {
+        Faixa f = pilha.takeLast();
+        int escolhido = -1;
+        double distancia = tolerancia;
+        for (int k = f.i + 1; k < f.j; ++k) {
+            double d = distanciaSegmento(x(k), y(k), x(f.i), y(f.i), x(f.j), y(f.j));
+            if (d > distancia) {
+                distancia = d;
+                escolhido = k;
+            }
+        }
+        if (escolhido >= 0) {
+            manter[escolhido] = 1;
+            pilha.append({f.i, escolhido});
+            pilha.append({escolhido, f.j});
+        }
+    }
+
+    for (int i = 0; i < n; ++i) {
+        if (manter[i]) {
+            saidaX.append(xs[i]);
+            saidaY.append(ys[i]);
+        }
+    }
+}
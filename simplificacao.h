@@ -0,0 +1,15 @@
+#ifndef SIMPLIFICACAO_H
+#define SIMPLIFICACAO_H
+
+#include <QVector>
+
+// Distância de (px, py) ao segmento ab (e não à reta), válida também com a == b.
+double distanciaSegmento(double px, double py, double ax, double ay, double bx, double by);
+
+// Douglas-Peucker sobre um polígono fechado de n vértices (xs[], ys[]).
+// Mantém os vértices cuja distância ao contorno simplificado passa de
+// 'tolerancia'; o resultado substitui o conteúdo de saidaX/saidaY.
+void simplificarPoligono(const double* xs, const double* ys, int n, double tolerancia,
+                         QVector<double>& saidaX, QVector<double>& saidaY);
+
+#endif // SIMPLIFICACAO_H
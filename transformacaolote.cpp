@@ -0,0 +1,121 @@
+#include "transformacaolote.h"
+#include "instrumentacao.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define TRANSFORMACAO_X86
+#include <immintrin.h>
+#endif
+
+#if defined(TRANSFORMACAO_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TRANSFORMACAO_AVX2
+#endif
+
+namespace {
+
+// Linhas superiores da matriz afim; a última linha é sempre (0, 0, 1).
+struct Coeficientes {
+    double a, b, c;
+    double d, e, f;
+};
+
+typedef void (*KernelTransformacao)(const Coeficientes& k, const double* xs, const double* ys,
+                                    double* saidaX, double* saidaY, int n);
+
+void kernelEscalar(const Coeficientes& k, const double* xs, const double* ys,
+                   double* saidaX, double* saidaY, int inicio, int n) {
+    for (int i = inicio; i < n; ++i) {
+        const double x = xs[i];
+        const double y = ys[i];
+        saidaX[i] = k.a * x + k.b * y + k.c;
+        saidaY[i] = k.d * x + k.e * y + k.f;
+    }
+}
+
+#ifndef TRANSFORMACAO_X86
+void transformarEscalar(const Coeficientes& k, const double* xs, const double* ys,
+                        double* saidaX, double* saidaY, int n) {
+    kernelEscalar(k, xs, ys, saidaX, saidaY, 0, n);
+}
+#else
+void transformarSSE2(const Coeficientes& k, const double* xs, const double* ys,
+                     double* saidaX, double* saidaY, int n) {
+    const __m128d a = _mm_set1_pd(k.a), b = _mm_set1_pd(k.b), c = _mm_set1_pd(k.c);
+    const __m128d d = _mm_set1_pd(k.d), e = _mm_set1_pd(k.e), f = _mm_set1_pd(k.f);
+
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d x = _mm_loadu_pd(xs + i);
+        const __m128d y = _mm_loadu_pd(ys + i);
+        _mm_storeu_pd(saidaX + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(a, x), _mm_mul_pd(b, y)), c));
+        _mm_storeu_pd(saidaY + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(d, x), _mm_mul_pd(e, y)), f));
+    }
+    kernelEscalar(k, xs, ys, saidaX, saidaY, i, n);
+}
+#endif
+
+#ifdef TRANSFORMACAO_AVX2
+// Sem FMA de propósito: o resultado fica idêntico ao dos caminhos SSE2 e escalar.
+__attribute__((target("avx2")))
+void transformarAVX2(const Coeficientes& k, const double* xs, const double* ys,
+                     double* saidaX, double* saidaY, int n) {
+    const __m256d a = _mm256_set1_pd(k.a), b = _mm256_set1_pd(k.b), c = _mm256_set1_pd(k.c);
+    const __m256d d = _mm256_set1_pd(k.d), e = _mm256_set1_pd(k.e), f = _mm256_set1_pd(k.f);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d x = _mm256_loadu_pd(xs + i);
+        const __m256d y = _mm256_loadu_pd(ys + i);
+        _mm256_storeu_pd(saidaX + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a, x), _mm256_mul_pd(b, y)), c));
+        _mm256_storeu_pd(saidaY + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(d, x), _mm256_mul_pd(e, y)), f));
+    }
+    kernelEscalar(k, xs, ys, saidaX, saidaY, i, n);
+}
+#endif
+
+struct Despacho {
+    KernelTransformacao kernel;
+    const char* nome;
+};
+
+Despacho escolherKernel() {
+#ifdef TRANSFORMACAO_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {transformarAVX2, "AVX2"};
+    }
+#endif
+#ifdef TRANSFORMACAO_X86
+    return {transformarSSE2, "SSE2"};
+#else
+    return {transformarEscalar, "Escalar"};
+#endif
+}
+
+const Despacho& despacho() {
+    static const Despacho escolhido = escolherKernel();
+    return escolhido;
+}
+
+Coeficientes coeficientes(const Mat3& m) {
+    return {m.at(0, 0), m.at(0, 1), m.at(0, 2),
+            m.at(1, 0), m.at(1, 1), m.at(1, 2)};
+}
+
+} // namespace
+
+void transformarLote(const Mat3& matriz, double* xs, double* ys, int n) {
+    if (n <= 0) return;
+    CONTAR(VERTICES_TRANSFORMADOS, n);
+    despacho().kernel(coeficientes(matriz), xs, ys, xs, ys, n);
+}
+
+void transformarLote(const Mat3& matriz, const double* xs, const double* ys,
+                     double* saidaX, double* saidaY, int n) {
+    if (n <= 0) return;
+    CONTAR(VERTICES_TRANSFORMADOS, n);
+    despacho().kernel(coeficientes(matriz), xs, ys, saidaX, saidaY, n);
+}
+
+const char* nomeKernelTransformacao() {
+    return despacho().nome;
+}
@@ -0,0 +1,17 @@
+#ifndef TRANSFORMACAOLOTE_H
+#define TRANSFORMACAOLOTE_H
+
+#include "matrix.h"
+
+// Aplica uma mesma transformação afim a n vértices guardados em x[] e y[].
+// A implementação (AVX2, SSE2 ou escalar) é escolhida em tempo de execução
+// de acordo com o processador.
+void transformarLote(const Mat3& matriz, double* xs, double* ys, int n);
+
+// Variante que escreve o resultado em outros vetores, preservando a entrada.
+void transformarLote(const Mat3& matriz, const double* xs, const double* ys,
+                     double* saidaX, double* saidaY, int n);
+
+const char* nomeKernelTransformacao();
+
+#endif // TRANSFORMACAOLOTE_H
@@ -23,15 +23,22 @@ void TransformadorCoordenadas::setViewport(int xmin, int ymin, int xmax, int yma
     recalcularTransformacao();
 }
 
-Matrix TransformadorCoordenadas::getTransformacao() const {
+void TransformadorCoordenadas::getViewport(int& xmin, int& ymin, int& xmax, int& ymax) const {
+    xmin = v_xmin;
+    ymin = v_ymin;
+    xmax = v_xmax;
+    ymax = v_ymax;
+}
+
+Mat3 TransformadorCoordenadas::getTransformacao() const {
     return matriz_transformacao;
 }
 
 void TransformadorCoordenadas::recalcularTransformacao() {
-    Matrix T1 = Matrix::criarMatrizTranslacao(-w_xmin, -w_ymin);
+    Mat3 T1 = Mat3::criarMatrizTranslacao(-w_xmin, -w_ymin);
     double sx = static_cast<double>(v_xmax - v_xmin) / (w_xmax - w_xmin);
     double sy = static_cast<double>(v_ymax - v_ymin) / (w_ymax - w_ymin);
-    Matrix S = Matrix::criarMatrizEscala(sx, sy);
-    Matrix T2 = Matrix::criarMatrizTranslacao(v_xmin, v_ymin);
+    Mat3 S = Mat3::criarMatrizEscala(sx, sy);
+    Mat3 T2 = Mat3::criarMatrizTranslacao(v_xmin, v_ymin);
     matriz_transformacao = T2 * S * T1;
 }
@@ -9,14 +9,15 @@ public:
 
     void setWindow(double xmin, double ymin, double xmax, double ymax);
     void setViewport(int xmin, int ymin, int xmax, int ymax);
+    void getViewport(int& xmin, int& ymin, int& xmax, int& ymax) const;
 
-    Matrix getTransformacao() const;
+    Mat3 getTransformacao() const;
 
 private:
     void recalcularTransformacao();
     double w_xmin, w_ymin, w_xmax, w_ymax;
     int v_xmin, v_ymin, v_xmax, v_ymax;
-    Matrix matriz_transformacao;
+    Mat3 matriz_transformacao;
 };
 
 #endif // TRANSFORMADOR_H
@@ -10,7 +10,7 @@ public:
     void setWindow(double xmin, double ymin, double xmax, double ymax);
     void setViewport(int xmin, int ymin, int xmax, int ymax);
 
-    Matrix getTransformacao() const;
+    Mat3 getTransformacao() const;
 
 private:
     void recalcularTransformacao();
@@ -21,7 +21,7 @@ private:
     int v_xmin, v_ymin, v_xmax, v_ymax;
 
     // Matriz de transformação combinada
-    Matrix matriz_transformacao;
+    Mat3 matriz_transformacao;
 };
 
 #endif // TRANSFORMADOR_H
@@ -1,8 +1,7 @@
 #include "windowgrafica.h"
-#include <QPainter>
 #include <algorithm>
-WindowGrafica::WindowGrafica(QString nome, const Ponto& p1, const Ponto& p2)
-    : ObjetoGrafico(nome, TipoObjeto::POLIGONO)
+WindowGrafica::WindowGrafica(ArmazemVertices* armazem, QString nome, const Ponto& p1, const Ponto& p2)
+    : ObjetoGrafico(armazem, nome, TipoObjeto::POLIGONO, 4)
 {
 
     double xmin = std::min(p1.getX(), p2.getX());
@@ -10,59 +9,65 @@ WindowGrafica::WindowGrafica(QString nome, const Ponto& p1, const Ponto& p2)
     double xmax = std::max(p1.getX(), p2.getX());
     double ymax = std::max(p1.getY(), p2.getY());
 
-    pontos.append(Ponto(xmin, ymin));
-    pontos.append(Ponto(xmax, ymin));
-    pontos.append(Ponto(xmax, ymax));
-    pontos.append(Ponto(xmin, ymax));
+    atualizarLimites(xmin, ymin, xmax, ymax);
 }
 
-void WindowGrafica::desenhar(QPainter& painter) const {
-    if (pontos.size() < 4) return;
+Ponto WindowGrafica::calcularCentro() const {
+    return Ponto(centroX, centroY);
+}
 
-    painter.save();
-    QPen pen(Qt::cyan, 2, Qt::DashDotLine);
-    painter.setPen(pen);
 
-    for (int i = 0; i < pontos.size(); ++i) {
-        const Ponto& p1 = pontos[i];
-        const Ponto& p2 = pontos[(i + 1) % pontos.size()];
-        painter.drawLine(p1.getX(), p1.getY(), p2.getX(), p2.getY());
-    }
-    painter.restore();
+LimitesWindow WindowGrafica::getLimites() const {
+    return getCaixa();
 }
 
-Ponto WindowGrafica::calcularCentro() const {
-    if (pontos.isEmpty()) return Ponto(0, 0);
-    double somaX = 0, somaY = 0;
-    for (const Ponto& p : pontos) {
-        somaX += p.getX();
-        somaY += p.getY();
-    }
-    return Ponto(somaX / pontos.size(), somaY / pontos.size());
+void WindowGrafica::atualizarLimites(double xmin, double ymin, double xmax, double ymax) {
+    centroX = (xmin + xmax) / 2.0;
+    centroY = (ymin + ymax) / 2.0;
+    largura = xmax - xmin;
+    altura = ymax - ymin;
+    angulo = 0.0;
+    recalcular();
 }
 
+void WindowGrafica::definir(double cx, double cy, double l, double a, double anguloGraus) {
+    centroX = cx;
+    centroY = cy;
+    largura = l;
+    altura = a;
+    angulo = anguloGraus;
+    recalcular();
+}
 
-LimitesWindow WindowGrafica::getLimites() const {
-    if (pontos.isEmpty()) return {0, 0, 0, 0};
+void WindowGrafica::transladar(double dx, double dy) {
+    centroX += dx;
+    centroY += dy;
+    recalcular();
+}
 
-    double xmin = pontos[0].getX();
-    double ymin = pontos[0].getY();
-    double xmax = xmin;
-    double ymax = ymin;
+void WindowGrafica::escalar(double sx, double sy) {
+    largura *= sx;
+    altura *= sy;
+    recalcular();
+}
 
-    for (const Ponto& p : pontos) {
-        xmin = std::min(xmin, p.getX());
-        xmax = std::max(xmax, p.getX());
-        ymin = std::min(ymin, p.getY());
-        ymax = std::max(ymax, p.getY());
-    }
-    return {xmin, ymin, xmax, ymax};
+void WindowGrafica::rotacionar(double anguloGraus) {
+    angulo += anguloGraus;
+    recalcular();
 }
 
-void WindowGrafica::atualizarLimites(double xmin, double ymin, double xmax, double ymax) {
-    pontos.clear();
-    pontos.append(Ponto(xmin, ymin));
-    pontos.append(Ponto(xmax, ymin));
-    pontos.append(Ponto(xmax, ymax));
-    pontos.append(Ponto(xmin, ymax));
+void WindowGrafica::recalcular() {
+    Mat3 T = Mat3::criarMatrizTranslacao(-centroX, -centroY);
+    Mat3 R = Mat3::criarMatrizRotacao(-angulo);
+    Mat3 S = Mat3::criarMatrizEscala(2.0 / largura, 2.0 / altura);
+    normalizacao = S * R * T;
+
+    // Cantos da window no mundo, usados para exibição e limites.
+    Mat3 paraMundo = Mat3::criarMatrizTranslacao(centroX, centroY) * Mat3::criarMatrizRotacao(angulo);
+    double mx = largura / 2.0;
+    double my = altura / 2.0;
+    setPonto(0, paraMundo * Ponto(-mx, -my));
+    setPonto(1, paraMundo * Ponto(mx, -my));
+    setPonto(2, paraMundo * Ponto(mx, my));
+    setPonto(3, paraMundo * Ponto(-mx, my));
 }
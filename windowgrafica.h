@@ -3,21 +3,39 @@
 
 #include "objetografico.h"
 
-struct LimitesWindow {
-    double xmin, ymin, xmax, ymax;
-};
+typedef CaixaLimite LimitesWindow;
 
+// A window funciona como uma câmera: guarda centro, dimensões e ângulo no
+// mundo e a matriz que leva o mundo para coordenadas normalizadas [-1, 1].
+// Navegar só altera esses parâmetros; os objetos da cena não são tocados.
 class WindowGrafica : public ObjetoGrafico {
 public:
-    WindowGrafica(QString nome, const Ponto& p1, const Ponto& p2);
+    WindowGrafica(ArmazemVertices* armazem, QString nome, const Ponto& p1, const Ponto& p2);
 
-    void desenhar(QPainter& painter) const override;
     Ponto calcularCentro() const override;
-    ObjetoGrafico* clone() const override { return new WindowGrafica(*this); }
 
     LimitesWindow getLimites() const;
+    const Mat3& getMatrizNormalizacao() const { return normalizacao; }
+    static LimitesWindow limitesNormalizados() { return {-1.0, -1.0, 1.0, 1.0}; }
 
     void atualizarLimites(double xmin, double ymin, double xmax, double ymax);
+    void definir(double centroX, double centroY, double largura, double altura, double anguloGraus);
+
+    double getLargura() const { return largura; }
+    double getAltura() const { return altura; }
+    double getAngulo() const { return angulo; }
+
+    void transladar(double dx, double dy);
+    void escalar(double sx, double sy);
+    void rotacionar(double anguloGraus);
+
+private:
+    void recalcular();
+
+    double centroX, centroY;
+    double largura, altura;
+    double angulo;
+    Mat3 normalizacao;
 };
 
 #endif // WINDOWGRAFICA_H